@@ -42,6 +42,8 @@ public class Minesweeper : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
+				"Sockets",
+				"Networking",
 				// ... add private dependencies that you statically link with here ...
 			}
 			);
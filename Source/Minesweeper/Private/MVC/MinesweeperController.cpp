@@ -1,79 +1,160 @@
 #include "MinesweeperController.h"
 #include "MinesweeperModel.h"
 #include "MinesweeperView.h"
-#include "Algo/AllOf.h"
-#include "Algo/AnyOf.h"
-#include "Algo/Count.h"
-#include "Algo/ForEach.h"
+#include "MinesweeperGrid.h"
+#include "Solver/MinesweeperBoardGenerator.h"
+#include "MinesweeperLatencyStats.h"
+#include "HAL/IConsoleManager.h"
+
+using namespace MinesweeperGrid;
+
+static TAutoConsoleVariable<int32> CVarMinesweeperCascadeBudget(
+	TEXT("Minesweeper.CascadeBudgetMicroseconds"),
+	0,
+	TEXT("Time a reveal cascade may take per frame before the rest continues on the next frame, as a growing wavefront. ")
+	TEXT("Zero reveals every cascade at once."));
 
 namespace
 {
-	const TArray<FIntPoint> NEIGHBOR_OFFSETS =
-	{
-		{-1, -1}, { 0, -1}, { 1, -1},
-		{-1,  0},           { 1,  0},
-		{-1,  1}, { 0,  1}, { 1,  1},
-	};
+	/** Cells revealed between two reads of the clock while a cascade runs on a budget */
+	constexpr int32 CASCADE_CLOCK_CHECK_INTERVAL = 256;
 
-	void RandomPopulateMines(TArray<FMineCell>& Cells, int32 MineCount, TOptional<int32> Seed = TOptional<int32>{})
+	/** Cycle count at which a cascade slice starting now has to stop, or never when running without budget */
+	uint64 GetCascadeSliceEndCycles()
 	{
-		check(MineCount > 0 && MineCount <= Cells.Num());
-
-		FRandomStream Stream;
-		Stream.Initialize(Seed ? *Seed : FMath::Rand());
-
-		for (int32 Idx = 0; Idx < MineCount; ++Idx)
+		const int32 BudgetMicroseconds = CVarMinesweeperCascadeBudget.GetValueOnAnyThread();
+		if (BudgetMicroseconds <= 0)
 		{
-			Cells[Idx].CellType = ECellType::Mine;
+			return MAX_uint64;
 		}
 
-		// Shuffling via placing random element at the top of the array
-		for (int32 Idx = 0; Idx < Cells.Num(); ++Idx)
-		{
-			const int32 RandomIdx = Stream.RandRange(Idx, Cells.Num() - 1);
-			Cells.Swap(Idx, RandomIdx);
-		}
-	}
-
-	bool IsValidCellPosition(FIntPoint GridSize, FIntPoint Pos)
-	{
-		return Pos.X >= 0 && Pos.X < GridSize.X
-			&& Pos.Y >= 0 && Pos.Y < GridSize.Y;
-	}
-
-	FMineCell& GetCell(TArray<FMineCell>& Cells, FIntPoint GridSize, FIntPoint Pos)
-	{
-		check(IsValidCellPosition(GridSize, Pos));
-		const int32 Index = Pos.Y * GridSize.X + Pos.X;
-		return Cells[Index];
+		return FPlatformTime::Cycles64() + static_cast<uint64>(BudgetMicroseconds * 1e-6 / FPlatformTime::GetSecondsPerCycle64());
 	}
 }
 
 FMinesweeperController::FMinesweeperController(FMinesweeperModel* InModel) :
-	Model{InModel}
+	Model{InModel},
+	bIsMinePlacementPending{false},
+	MinePlacementIdx{INDEX_NONE},
+	bIsCountingLazily{false},
+	CascadeHead{0},
+	LatencyStats{nullptr},
+	GameStartSeconds{0.0},
+	MoveCount{0},
+	bIsGameRecorded{false},
+	bIsCascadeTickedExternally{false}
 {
 	InitializeGame(FMinesweeperGameConfig::MakeDefaultConfig());
 }
 
+FMinesweeperController::~FMinesweeperController()
+{
+	if (CascadeTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(CascadeTickerHandle);
+	}
+}
+
 void FMinesweeperController::HandleOnStartNewGame(FMinesweeperGameConfig NewConfig)
 {
 	check(NewConfig.IsValid())
 	InitializeGame(NewConfig);
+	if (LatencyStats)
+	{
+		LatencyStats->Reset();
+	}
 	Model->OnGameConfigUpdated.ExecuteIfBound(NewConfig);
+	Model->OnGameStarted.ExecuteIfBound(Model->GameConfig, Model->GameState);
 }
 
 void FMinesweeperController::HandleOnPlayerInput(FPlayerInput Input)
 {
+	// Inputs arriving mid-cascade apply once it completes, repeated ones only once
+	if (IsCascadeInProgress())
+	{
+		QueuedInputs.AddUnique(Input);
+		return;
+	}
+
 	if (Model->GameState.State == EMinesweeperGameState::Running)
 	{
+		const uint64 StartCycles = FPlatformTime::Cycles64();
 		const bool bHasGridChanged = AdvanceGame(Input);
 		if (bHasGridChanged)
 		{
-			Model->OnMineGridChanged.ExecuteIfBound(Model->GameConfig, Model->GameState);
+			if (LatencyStats)
+			{
+				LatencyStats->RecordControllerTime(Input.InputCycles, StartCycles, FPlatformTime::Cycles64());
+			}
+
+			NotifyGridChanged();
 		}
 	}
 }
 
+void FMinesweeperController::HandleOnUndoMove()
+{
+	CompleteCascade();
+
+	if (Model->Journal.Undo(Model->GameState, [this](int32 Idx, ECellState PreviousState, ECellState NewState)
+	{
+		OnCellStateChanged(Idx, PreviousState, NewState);
+	}))
+	{
+		NotifyGridChanged();
+	}
+}
+
+void FMinesweeperController::HandleOnRedoMove()
+{
+	CompleteCascade();
+
+	if (Model->Journal.Redo(Model->GameState, [this](int32 Idx, ECellState PreviousState, ECellState NewState)
+	{
+		OnCellStateChanged(Idx, PreviousState, NewState);
+	}))
+	{
+		NotifyGridChanged();
+	}
+}
+
+void FMinesweeperController::SetCascadeTickedExternally(bool bInIsCascadeTickedExternally)
+{
+	bIsCascadeTickedExternally = bInIsCascadeTickedExternally;
+}
+
+void FMinesweeperController::SetLatencyStats(FMinesweeperLatencyStats* InLatencyStats)
+{
+	LatencyStats = InLatencyStats;
+}
+
+void FMinesweeperController::ContinueCascade()
+{
+	if (!IsCascadeInProgress())
+	{
+		return;
+	}
+
+	const uint64 EndCycles = GetCascadeSliceEndCycles();
+	const bool bIsFinished = DispatchTopology(Model->GameConfig, [this, EndCycles](const auto& Topology)
+	{
+		return StepCascade(Topology, EndCycles);
+	});
+
+	if (bIsFinished)
+	{
+		FinishMove();
+	}
+
+	// Partial reveals get drawn too, which shows the cascade as a growing wavefront
+	NotifyGridChanged();
+
+	if (bIsFinished)
+	{
+		ApplyQueuedInputs();
+	}
+}
+
 void FMinesweeperController::InitializeGame(FMinesweeperGameConfig NewConfig)
 {
 	FMinesweeperGameConfig& GameConfig = Model->GameConfig;
@@ -81,153 +162,617 @@ void FMinesweeperController::InitializeGame(FMinesweeperGameConfig NewConfig)
 
 	GameConfig = NewConfig;
 
-	const FIntPoint GridSize = GameConfig.GridSize;
-	const int32 ColCount = GridSize.X;
-	const int32 RowCount = GridSize.Y;
-	const int32 CellCount = RowCount * ColCount;
+	// Resolving the seed up front, so that the record of every game tells how to replay it,
+	// along with the target 3BV range in the config and the first visit of a no-guess game
+	if (!GameConfig.RandomSeed)
+	{
+		GameConfig.RandomSeed = FMath::Rand();
+	}
+
+	const int32 CellCount = GameConfig.GetCellCount();
 
-	GameState.Cells.Empty();
+	// Buffers of the previous game are released at once, their memory and that of the board kept for this one
+	Model->Arena.Reset();
+	GameState.Cells.Reset();
 	GameState.Cells.AddZeroed(CellCount);
 	GameState.State = EMinesweeperGameState::Running;
+	GameState.RemainingMineCount = GameConfig.MineCount;
+	Model->Journal.Reset();
+	Frontier.Reset(CellCount, Model->Arena);
+
+	// A cascade of the previous game is abandoned along with any input waiting for it
+	// Cascades queue every cell at most once, so the queue never outgrows the board and never grows mid-cascade
+	CascadeQueue.Reset();
+	CascadeQueue.Reserve(CellCount);
+	CascadeHead = 0;
+	CascadeFlaggedCells.Reset();
+	QueuedInputs.Reset();
+	ChangedCells.Reset();
+
+	GameStartSeconds = 0.0;
+	MoveCount = 0;
+	bIsGameRecorded = false;
+
+	// No-guess boards depend on where the player clicks first, so mines are placed upon first visit
+	bIsMinePlacementPending = GameConfig.Generation == EMineGeneration::NoGuess;
+	MinePlacementIdx = INDEX_NONE;
+	bIsCountingLazily = GameConfig.bLazyNeighborCounts && !bIsMinePlacementPending && !GameConfig.TargetThreeBV;
+
+	if (bIsMinePlacementPending)
+	{
+		ZeroRegions.Reset();
+		TileSummaries.Reset();
+		GameState.BoardMetrics.Reset();
+	}
+	else
+	{
+		FMinesweeperBoardGenerator::GenerateRandom(GameState.Cells, GameConfig, Model->Arena);
+		BuildZeroRegions();
+		CalculateBoardMetrics();
+		TileSummaries.Build(GameState.Cells, Model->Arena);
+	}
+
+	if (bIsCountingLazily)
+	{
+		CountedCells = Model->Arena.AllocateZeroed<bool>(CellCount);
+	}
+	else
+	{
+		CountedCells = {};
+	}
+}
+
+bool FMinesweeperController::AdvanceGame(FPlayerInput Input)
+{
+	FMinesweeperGameState& GameState = Model->GameState;
 
-	RandomPopulateMines(GameState.Cells, GameConfig.MineCount);
+	check(GameState.State == EMinesweeperGameState::Running);
+	check(IsValidCellPosition(Model->GameConfig, Input.Pos));
 
-	// Calculate neighbor mine count
-	for (int32 Idx = 0; Idx < CellCount; ++Idx)
+	// The clock starts with the first move rather than with the game
+	if (GameStartSeconds == 0.0)
 	{
-		const int32 X = Idx % ColCount;
-		const int32 Y = Idx / ColCount;
-		FMineCell& Cell = GetCell(GameState.Cells, GridSize, {X, Y});
+		GameStartSeconds = FPlatformTime::Seconds();
+	}
 
-		Cell.NeighborMineCount = Algo::CountIf(NEIGHBOR_OFFSETS, [&](const FIntPoint Offset)
+	Model->Journal.BeginMove(GameState.State);
+
+	const bool bGridHasChanged = DispatchTopology(Model->GameConfig, [this, Input](const auto& Topology)
+	{
+		const auto InputPos = Topology.MakePosition(Input.Pos);
+		const int32 InputIdx = Topology.GetCellIndex(InputPos);
+
+		switch (Input.Type)
 		{
-			const FIntPoint Neighbor = FIntPoint{X, Y} + Offset;
-			return IsValidCellPosition(GameConfig.GridSize, Neighbor) && GetCell(GameState.Cells, GridSize, Neighbor).IsMine();
-		});
+		case EInputType::Visit:
+		default:
+			return VisitCell(InputIdx, InputPos, Topology);
+		case EInputType::Flag:
+			return FlagCell(InputIdx, InputPos, Topology);
+		}
+	});
+
+	MoveCount += bGridHasChanged;
+
+	if (IsCascadeInProgress())
+	{
+		StartCascade();
 	}
+
+	// A cascade continuing on later frames finishes the move once it completes
+	if (bGridHasChanged && !IsCascadeInProgress())
+	{
+		FinishMove();
+	}
+
+	return bGridHasChanged;
 }
 
-bool FMinesweeperController::AdvanceGame(FPlayerInput Input)
+template <typename TTopology>
+bool FMinesweeperController::VisitCell(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology)
 {
-	const FIntPoint GridSize = Model->GameConfig.GridSize;
+	const FMinesweeperGameConfig& GameConfig = Model->GameConfig;
 	FMinesweeperGameState& GameState = Model->GameState;
 
-	check(GameState.State == EMinesweeperGameState::Running);
-	check(IsValidCellPosition(GridSize, Input.Pos));
+	if (bIsMinePlacementPending)
+	{
+		FMinesweeperBoardGenerator::GenerateNoGuess(GameState.Cells, GameConfig, Idx, Model->Arena);
+		MinePlacementIdx = Idx;
+		BuildZeroRegions();
+		CalculateBoardMetrics();
+		TileSummaries.Build(GameState.Cells, Model->Arena);
+		bIsMinePlacementPending = false;
+	}
+
+	const FMineCell& Cell = GameState.Cells[Idx];
 
-	bool bGridHasChanged;
+	// Visiting a number again chords it
+	if (Cell.IsRevealed())
+	{
+		return ChordCell(Idx, Pos, Topology);
+	}
+
+	// Flags protect cells from being visited by accident
+	if (Cell.IsFlagged())
+	{
+		return false;
+	}
+
+	return RevealCell(Idx, Pos, Topology);
+}
+
+template <typename TTopology>
+bool FMinesweeperController::FlagCell(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology)
+{
+	// No-guess generation replaces the whole board upon first visit, flags included
+	if (bIsMinePlacementPending)
+	{
+		return false;
+	}
 
-	switch (Input.Type)
+	switch (Model->GameState.Cells[Idx].CellState)
 	{
-	case EInputType::Visit:
+	case ECellState::Hidden:
+		SetCellState(Idx, Pos, ECellState::Flagged, Topology);
+		return true;
+	case ECellState::Flagged:
+		SetCellState(Idx, Pos, ECellState::Hidden, Topology);
+		return true;
 	default:
-		bGridHasChanged = VisitCell(Input.Pos);
-		break;
-	case EInputType::Flag:
-		bGridHasChanged = FlagCell(Input.Pos);
-		break;
+		return false;
 	}
+}
 
-	if (bGridHasChanged)
+template <typename TTopology>
+bool FMinesweeperController::ChordCell(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology)
+{
+	using FPosition = typename TTopology::FPosition;
+
+	const TArray<FMineCell>& Cells = Model->GameState.Cells;
+	const FMineCell& Cell = Cells[Idx];
+
+	// Flag count is kept per cell, so eligibility takes no look at the neighbors
+	if (Cell.NeighborMineCount == 0 || Cell.NeighborFlagCount != Cell.NeighborMineCount)
 	{
-		UpdateGameState();
+		return false;
+	}
+
+	// Gathered up front since revealing one neighbor may cascade into the others
+	TArray<TPair<int32, FPosition>, TInlineAllocator<TTopology::MAX_NEIGHBOR_COUNT>> HiddenNeighbors;
+	Topology.ForEachNeighbor(Pos, [&](int32 NeighborIdx, const FPosition& NeighborPos)
+	{
+		if (Cells[NeighborIdx].IsHidden())
+		{
+			HiddenNeighbors.Emplace(NeighborIdx, NeighborPos);
+		}
+	});
+
+	bool bGridHasChanged = false;
+	for (const TPair<int32, FPosition>& Neighbor : HiddenNeighbors)
+	{
+		// A wrong flag means a mine among them, which ends the game right there
+		if (Cells[Neighbor.Key].IsHidden())
+		{
+			bGridHasChanged |= RevealCell(Neighbor.Key, Neighbor.Value, Topology);
+		}
+
+		if (Model->GameState.State == EMinesweeperGameState::GameOver_Lose)
+		{
+			break;
+		}
 	}
 
 	return bGridHasChanged;
 }
 
-bool FMinesweeperController::VisitCell(FIntPoint Pos)
+template <typename TTopology>
+bool FMinesweeperController::RevealCell(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology)
 {
-	const FMinesweeperGameConfig& GameConfig = Model->GameConfig;
 	FMinesweeperGameState& GameState = Model->GameState;
-	FMineCell& InputCell = GetCell(GameState.Cells, GameConfig.GridSize, Pos);
 
 	// Clicked on mine, game over
-	if (InputCell.IsMine())
+	if (GameState.Cells[Idx].IsMine())
 	{
-		InputCell.CellState = ECellState::Exploded;
+		SetCellState(Idx, Pos, ECellState::Exploded, Topology);
 		GameState.State = EMinesweeperGameState::GameOver_Lose;
 		return true;
 	}
 
-	// Recursively visit neighbors that can be revealed
-	const bool bGridHasChanged = FloodFill(Pos);
+	// Reveal neighbors that can be revealed
+	return FloodFill(Idx, Pos, Topology);
+}
 
-	return bGridHasChanged;
+template <typename TTopology>
+bool FMinesweeperController::FloodFill(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology)
+{
+	FMinesweeperGameState& GameState = Model->GameState;
+	const FMineCell& Cell = GameState.Cells[Idx];
+
+	if (Cell.IsMine() || !Cell.IsHidden())
+	{
+		return false;
+	}
+
+	// Without counts there are no zero regions, and a budgeted cascade has to grow as a wavefront,
+	// so either way the cascade is searched as it goes
+	const bool bIsBudgeted = CVarMinesweeperCascadeBudget.GetValueOnAnyThread() > 0;
+	if (bIsCountingLazily || bIsBudgeted)
+	{
+		SeedCascade(Idx, Pos, Topology);
+		return true;
+	}
+
+	const int32 RegionId = ZeroRegions.GetRegionId(Idx);
+	if (RegionId == INDEX_NONE)
+	{
+		SetCellState(Idx, Pos, ECellState::Revealed, Topology);
+		return true;
+	}
+
+	// Region along with its numbered border got labeled upon mine placement, no searching needed.
+	// Labels only hold indices, every cell of the region gets revealed once per game either way
+	for (const int32 RegionCellIdx : ZeroRegions.GetRegionCells(RegionId))
+	{
+		// Flags stay, even on cells the player got wrong, while the rest of the region gets revealed past them
+		if (GameState.Cells[RegionCellIdx].IsHidden())
+		{
+			SetCellState(RegionCellIdx, Topology.GetCellPosition(RegionCellIdx), ECellState::Revealed, Topology);
+		}
+	}
+
+	return true;
 }
 
-bool FMinesweeperController::FlagCell(FIntPoint Pos)
+template <typename TTopology>
+void FMinesweeperController::SeedCascade(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology)
 {
-	UE_LOG(LogTemp, Warning, TEXT("Flagging not currently supported."));
-	return false;
+	EnsureNeighborMineCount(Idx, Pos, Topology);
+	SetCellState(Idx, Pos, ECellState::Revealed, Topology);
+	CascadeQueue.Add(FCascadeCell{Idx, Topology.MakeInputPosition(Pos)});
 }
 
-bool FMinesweeperController::FloodFill(FIntPoint Pos)
+void FMinesweeperController::StartCascade()
 {
-	const FMinesweeperGameConfig& GameConfig = Model->GameConfig;
-	FMinesweeperGameState& GameState = Model->GameState;
+	// First slice runs right away, so that small cascades complete within the click
+	const uint64 EndCycles = GetCascadeSliceEndCycles();
+	const bool bIsFinished = DispatchTopology(Model->GameConfig, [this, EndCycles](const auto& Topology)
+	{
+		return StepCascade(Topology, EndCycles);
+	});
 
-	if (IsValidCellPosition(GameConfig.GridSize, Pos))
+	if (!bIsFinished && !bIsCascadeTickedExternally && !CascadeTickerHandle.IsValid())
 	{
-		FMineCell& Cell = GetCell(GameState.Cells, GameConfig.GridSize, Pos);
-		const bool bShouldReveal = !Cell.IsMine() && !Cell.IsRevealed();
+		CascadeTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([this](float)
+		{
+			ContinueCascade();
+			if (!IsCascadeInProgress())
+			{
+				CascadeTickerHandle.Reset();
+				return false;
+			}
+			return true;
+		}));
+	}
+}
 
-		if (bShouldReveal)
+template <typename TTopology>
+bool FMinesweeperController::StepCascade(const TTopology& Topology, uint64 EndCycles)
+{
+	using FPosition = typename TTopology::FPosition;
+
+	const TArray<FMineCell>& Cells = Model->GameState.Cells;
+
+	// First in first out, so that cells get revealed in order of their distance to the click
+	for (int32 StepCount = 1; CascadeHead < CascadeQueue.Num(); ++StepCount)
+	{
+		if (StepCount % CASCADE_CLOCK_CHECK_INTERVAL == 0 && FPlatformTime::Cycles64() >= EndCycles)
 		{
-			Cell.CellState = ECellState::Revealed;
+			return false;
+		}
+
+		const FCascadeCell Cell = CascadeQueue[CascadeHead++];
+		const FPosition Pos = Topology.MakePosition(Cell.Pos);
+		if (EnsureNeighborMineCount(Cell.Idx, Pos, Topology) > 0)
+		{
+			continue;
+		}
+
+		// Neighbors of a cell without neighboring mines are never mines themselves
+		Topology.ForEachNeighbor(Pos, [&](int32 NeighborIdx, const FPosition& NeighborPos)
+		{
+			const FMineCell& Neighbor = Cells[NeighborIdx];
+
+			// Counted upon reveal, so that a partially drawn wavefront never shows a cell without its count
+			if (Neighbor.IsHidden())
+			{
+				EnsureNeighborMineCount(NeighborIdx, NeighborPos, Topology);
+				SetCellState(NeighborIdx, NeighborPos, ECellState::Revealed, Topology);
+				CascadeQueue.Add(FCascadeCell{NeighborIdx, Topology.MakeInputPosition(NeighborPos)});
+				return;
+			}
 
-			// Recursively flood-filling cells whose neighbors have no mines
-			if (Cell.NeighborMineCount == 0)
+			// Same rule as zero regions, flags stay but the cascade carries on through the rest of the region
+			if (Neighbor.IsFlagged())
 			{
-				Algo::ForEach(NEIGHBOR_OFFSETS, [Pos, this](const FIntPoint Offset)
+				bool bIsAlreadyQueued = false;
+				CascadeFlaggedCells.Add(NeighborIdx, &bIsAlreadyQueued);
+				if (!bIsAlreadyQueued)
 				{
-					const FIntPoint NeighborPos = Pos + Offset;
-					FloodFill(NeighborPos);
-				});
+					CascadeQueue.Add(FCascadeCell{NeighborIdx, Topology.MakeInputPosition(NeighborPos)});
+				}
 			}
-		}
+		});
+	}
+
+	CascadeQueue.Reset();
+	CascadeHead = 0;
+	CascadeFlaggedCells.Reset();
+	return true;
+}
 
-		return bShouldReveal;
+void FMinesweeperController::CompleteCascade()
+{
+	if (!IsCascadeInProgress())
+	{
+		return;
 	}
 
-	return false;
+	DispatchTopology(Model->GameConfig, [this](const auto& Topology)
+	{
+		StepCascade(Topology, MAX_uint64);
+	});
+	FinishMove();
+	ApplyQueuedInputs();
 }
 
-void FMinesweeperController::UpdateGameState()
+void FMinesweeperController::ApplyQueuedInputs()
 {
-	FMinesweeperGameState& GameState = Model->GameState;
+	// Stops as soon as one of them starts another cascade, the rest wait for that one
+	while (QueuedInputs.Num() > 0 && !IsCascadeInProgress())
+	{
+		const FPlayerInput Input = QueuedInputs[0];
+		QueuedInputs.RemoveAt(0, 1, false);
+		HandleOnPlayerInput(Input);
+	}
+}
 
-	const bool bGameOverLose = Algo::AnyOf(GameState.Cells, [](const FMineCell& Cell)
+void FMinesweeperController::FinishMove()
+{
+	DispatchTopology(Model->GameConfig, [this](const auto& Topology)
 	{
-		return Cell.CellState == ECellState::Exploded;
+		UpdateGameState(Topology);
 	});
+	Model->Journal.EndMove(Model->GameState.State);
 
-	if (bGameOverLose)
+	if (Model->GameState.State != EMinesweeperGameState::Running && !bIsGameRecorded)
 	{
-		// Reveal all mines except the exploded mine
-		Algo::ForEach(GameState.Cells, [](FMineCell& Cell)
+		RecordFinishedGame();
+	}
+}
+
+void FMinesweeperController::RecordFinishedGame()
+{
+	const FMinesweeperGameState& GameState = Model->GameState;
+
+	bIsGameRecorded = true;
+
+	FMinesweeperGameRecord Record;
+	Record.Config = Model->GameConfig;
+	Record.StartIdx = MinePlacementIdx;
+	Record.FinishTime = FDateTime::UtcNow();
+	Record.DurationSeconds = FPlatformTime::Seconds() - GameStartSeconds;
+	Record.Outcome = GameState.State;
+	Record.ThreeBV = GameState.BoardMetrics ? GameState.BoardMetrics->ThreeBV : INDEX_NONE;
+	Record.MoveCount = MoveCount;
+
+	Model->OnGameFinished.ExecuteIfBound(Record);
+}
+
+template <typename TTopology>
+int32 FMinesweeperController::EnsureNeighborMineCount(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology)
+{
+	TArray<FMineCell>& Cells = Model->GameState.Cells;
+
+	if (bIsCountingLazily && !CountedCells[Idx])
+	{
+		int32 NeighborMineCount = 0;
+		Topology.ForEachNeighborIndex(Pos, [&](int32 NeighborIdx)
 		{
-			if (Cell.IsMine() && Cell.CellState != ECellState::Exploded)
+			NeighborMineCount += Cells[NeighborIdx].IsMine();
+		});
+
+		Cells[Idx].NeighborMineCount = NeighborMineCount;
+		CountedCells[Idx] = true;
+	}
+
+	return Cells[Idx].NeighborMineCount;
+}
+
+template <typename TTopology>
+void FMinesweeperController::UpdateGameState(const TTopology& Topology)
+{
+	FMinesweeperGameState& GameState = Model->GameState;
+	const TArray<FMineCell>& Cells = GameState.Cells;
+
+	// Only a visited mine ends the game this way, and visiting it already set the state
+	if (GameState.State == EMinesweeperGameState::GameOver_Lose)
+	{
+		// Reveal all mines except the exploded mine, tiles without mines have nothing to reveal
+		for (int32 Tile = 0; Tile < TileSummaries.Num(); ++Tile)
+		{
+			if (!TileSummaries.ContainsMine(Tile))
 			{
-				Cell.CellState = ECellState::Revealed;
+				continue;
 			}
-		});
-		GameState.State = EMinesweeperGameState::GameOver_Lose;
+
+			for (int32 Idx = TileSummaries.GetTileStart(Tile); Idx < TileSummaries.GetTileEnd(Tile); ++Idx)
+			{
+				if (Cells[Idx].IsMine() && Cells[Idx].IsHidden())
+				{
+					SetCellState(Idx, Topology.GetCellPosition(Idx), ECellState::Revealed, Topology);
+				}
+			}
+		}
 		return;
 	}
 
-	const bool bGameOverWin = Algo::AllOf(GameState.Cells, [](const FMineCell& Cell)
+	// A fully revealed tile has no hidden safe cell, and a hidden cell in a tile without mines is one
+	bool bGameOverWin = true;
+	for (int32 Tile = 0; Tile < TileSummaries.Num() && bGameOverWin; ++Tile)
 	{
-		return Cell.IsRevealed() ^ Cell.IsMine();
-	});
+		if (TileSummaries.IsAllRevealed(Tile))
+		{
+			continue;
+		}
+
+		if (!TileSummaries.ContainsMine(Tile))
+		{
+			bGameOverWin = false;
+			break;
+		}
+
+		for (int32 Idx = TileSummaries.GetTileStart(Tile); Idx < TileSummaries.GetTileEnd(Tile); ++Idx)
+		{
+			if (!Cells[Idx].IsRevealed() && !Cells[Idx].IsMine())
+			{
+				bGameOverWin = false;
+				break;
+			}
+		}
+	}
 
 	if (bGameOverWin)
 	{
 		// Reveal all cells
-		Algo::ForEach(GameState.Cells, [](FMineCell& Cell)
+		for (int32 Tile = 0; Tile < TileSummaries.Num(); ++Tile)
 		{
-			Cell.CellState = ECellState::Revealed;
-		});
+			if (TileSummaries.IsAllRevealed(Tile))
+			{
+				continue;
+			}
+
+			// Every flag left is on a mine by now, so flags stay
+			for (int32 Idx = TileSummaries.GetTileStart(Tile); Idx < TileSummaries.GetTileEnd(Tile); ++Idx)
+			{
+				if (Cells[Idx].IsHidden())
+				{
+					SetCellState(Idx, Topology.GetCellPosition(Idx), ECellState::Revealed, Topology);
+				}
+			}
+		}
 		GameState.State = EMinesweeperGameState::GameOver_Win;
 	}
+}
+
+void FMinesweeperController::BuildZeroRegions()
+{
+	if (bIsCountingLazily)
+	{
+		ZeroRegions.Reset();
+		return;
+	}
+
+	DispatchTopology(Model->GameConfig, [this](const auto& Topology)
+	{
+		ZeroRegions.Build(Model->GameState.Cells, Topology, Model->Arena);
+	});
+}
+
+void FMinesweeperController::CalculateBoardMetrics()
+{
+	FMinesweeperGameState& GameState = Model->GameState;
+
+	if (bIsCountingLazily)
+	{
+		GameState.BoardMetrics.Reset();
+		return;
+	}
+
+	const TArrayView<int32> Parents = Model->Arena.Allocate<int32>(GameState.Cells.Num());
+	GameState.BoardMetrics = DispatchTopology(Model->GameConfig, [&GameState, Parents](const auto& Topology)
+	{
+		return MinesweeperGrid::CalculateBoardMetrics(GameState.Cells, Topology, Parents);
+	});
+}
+
+template <typename TTopology>
+void FMinesweeperController::SetCellState(
+	int32 Idx,
+	const typename TTopology::FPosition& Pos,
+	ECellState NewState,
+	const TTopology& Topology)
+{
+	FMineCell& Cell = Model->GameState.Cells[Idx];
+	const ECellState PreviousState = Cell.CellState;
+	Model->Journal.RecordCellChange(Idx, PreviousState, NewState);
+
+	// Same order as undo and redo, so that whatever follows the change sees the board already changed
+	Cell.CellState = NewState;
+	OnCellStateChanged(Idx, Pos, PreviousState, NewState, Topology);
+}
+
+void FMinesweeperController::OnCellStateChanged(int32 Idx, ECellState PreviousState, ECellState NewState)
+{
+	DispatchTopology(Model->GameConfig, [this, Idx, PreviousState, NewState](const auto& Topology)
+	{
+		OnCellStateChanged(Idx, Topology.GetCellPosition(Idx), PreviousState, NewState, Topology);
+	});
+}
+
+template <typename TTopology>
+void FMinesweeperController::OnCellStateChanged(
+	int32 Idx,
+	const typename TTopology::FPosition& Pos,
+	ECellState PreviousState,
+	ECellState NewState,
+	const TTopology& Topology)
+{
+	TileSummaries.OnCellStateChanged(Idx, PreviousState, NewState);
+	RecordChangedCell(Idx);
+
+	const int32 FlagDelta = (NewState == ECellState::Flagged) - (PreviousState == ECellState::Flagged);
+	// An exploded cell leaves the frontier just like a revealed one
+	const int32 UncoverDelta = (NewState == ECellState::Revealed || NewState == ECellState::Exploded)
+		- (PreviousState == ECellState::Revealed || PreviousState == ECellState::Exploded);
+	if (FlagDelta == 0 && UncoverDelta == 0)
+	{
+		return;
+	}
+
+	FMinesweeperGameState& GameState = Model->GameState;
+	GameState.RemainingMineCount -= FlagDelta;
+
+	// Neighbors keep their own flag counts, which is what makes chording free of rescans
+	if (FlagDelta != 0)
+	{
+		Topology.ForEachNeighborIndex(Pos, [&GameState, FlagDelta](int32 NeighborIdx)
+		{
+			GameState.Cells[NeighborIdx].NeighborFlagCount += FlagDelta;
+		});
+	}
+
+	if (UncoverDelta > 0)
+	{
+		Frontier.OnCellRevealed(GameState.Cells, Idx, Pos, Topology);
+	}
+	else if (UncoverDelta < 0)
+	{
+		Frontier.OnCellConcealed(GameState.Cells, Idx, Pos, Topology);
+	}
+}
+
+void FMinesweeperController::RecordChangedCell(int32 Idx)
+{
+	// Nobody follows the board incrementally unless spectated or shown on the game thread
+	if (Model->OnCellsChanged.IsBound())
+	{
+		ChangedCells.Add(Idx);
+	}
+}
+
+void FMinesweeperController::NotifyGridChanged()
+{
+	Model->OnCellsChanged.Broadcast(Model->GameState, ChangedCells);
+	Model->OnMineGridChanged.ExecuteIfBound(Model->GameConfig, Model->GameState);
+	ChangedCells.Reset();
 }
\ No newline at end of file
@@ -1,6 +1,11 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "MinesweeperGame.h"
+#include "MinesweeperFrontier.h"
+#include "MinesweeperTileSummaries.h"
+#include "MinesweeperZeroRegions.h"
+#include "Containers/Ticker.h"
 
 /**
  * Controller of minesweeper editor window in MVC pattern. Designed for:
@@ -11,12 +16,39 @@ class FMinesweeperController
 {
 public:
 	explicit FMinesweeperController(struct FMinesweeperModel* InModel);
+	~FMinesweeperController();
 
 	FMinesweeperController(const FMinesweeperController&) = delete;
 	FMinesweeperController& operator=(const FMinesweeperController&) = delete;
 
 	void HandleOnStartNewGame(struct FMinesweeperGameConfig NewConfig);
 	void HandleOnPlayerInput(struct FPlayerInput Input);
+	void HandleOnUndoMove();
+	void HandleOnRedoMove();
+
+	/**
+	 * By default a cascade exceeding its time budget continues on the core ticker.
+	 * An owner running the controller on another thread ticks it through ContinueCascade instead.
+	 */
+	void SetCascadeTickedExternally(bool bInIsCascadeTickedExternally);
+
+	/** Reveals the next slice of the cascade in progress within the time budget and notifies the partial result */
+	void ContinueCascade();
+
+	/** Unrevealed cells next to revealed ones, for hints and solvers to start from without scanning the board */
+	FORCEINLINE const FMinesweeperFrontier& GetFrontier() const
+	{
+		return Frontier;
+	}
+
+	/** Stats to record controller time of every move into, none by default */
+	void SetLatencyStats(class FMinesweeperLatencyStats* InLatencyStats);
+
+	/** Whether a cascade is still revealing cells, in which case game over is yet to be evaluated */
+	FORCEINLINE bool IsCascadeInProgress() const
+	{
+		return CascadeHead < CascadeQueue.Num();
+	}
 
 private:
 	void InitializeGame(FMinesweeperGameConfig NewConfig);
@@ -24,19 +56,145 @@ private:
 	/** Advance game based on player input. Returns true if mine grid needs redrawing */
 	bool AdvanceGame(FPlayerInput Input);
 
-	/** Visit a cell at given position. Returns true if mine grid needs redrawing */
-	bool VisitCell(FIntPoint Pos);
+	/**
+	 * Visit a cell at given index. Returns true if mine grid needs redrawing.
+	 * Cells of a move come with their position, carried along rather than derived from the index again.
+	 */
+	template <typename TTopology>
+	bool VisitCell(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology);
 
-	/** Flag a cell at given position. Returns true if mine grid needs redrawing */
-	bool FlagCell(FIntPoint Pos);
+	/** Flag or unflag a cell at given index. Returns true if mine grid needs redrawing */
+	template <typename TTopology>
+	bool FlagCell(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology);
 
-	/** Flood fill algorithm to recursively reveal cells if possible. */
+	/**
+	 * Reveals every hidden neighbor of a revealed cell once as many of its neighbors are flagged as it has mines.
+	 * Returns true if mine grid needs redrawing
+	 */
+	template <typename TTopology>
+	bool ChordCell(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology);
+
+	/** Reveals a hidden cell, which ends the game if it is a mine. Returns true if mine grid needs redrawing */
+	template <typename TTopology>
+	bool RevealCell(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology);
+
+	/** Reveals a cell, along with its whole zero region when it has no neighboring mines. */
 	/** Returns true if mine grid needs redrawing */
-	bool FloodFill(FIntPoint Pos);
+	template <typename TTopology>
+	bool FloodFill(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology);
+
+	/** Reveals a cell and adds it to the cascade, several cells revealed by one move share a cascade */
+	template <typename TTopology>
+	void SeedCascade(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology);
+
+	/** Runs the first slice of the cascade seeded by current move right away, the rest on later frames */
+	void StartCascade();
+
+	/**
+	 * Reveals cascade cells breadth first, counting neighbor mines on the way, until the cycle counter hits EndCycles.
+	 * Returns true once the cascade has completed.
+	 */
+	template <typename TTopology>
+	bool StepCascade(const TTopology& Topology, uint64 EndCycles);
+
+	/** Reveals the rest of the cascade in progress regardless of budget */
+	void CompleteCascade();
+
+	/** Applies inputs that arrived while a cascade was in progress */
+	void ApplyQueuedInputs();
+
+	/** Evaluates game over and closes the journal entry of the current move */
+	void FinishMove();
+
+	/** Reports the game once it is over for the first time, a game undone and finished again is not reported twice */
+	void RecordFinishedGame();
+
+	/** Keeps tile summaries, flag counts, frontier and changed cells in sync with a cell whose new state is written already */
+	void OnCellStateChanged(int32 Idx, ECellState PreviousState, ECellState NewState);
+
+	/** Same, for a cell whose position the caller already has */
+	template <typename TTopology>
+	void OnCellStateChanged(
+		int32 Idx,
+		const typename TTopology::FPosition& Pos,
+		ECellState PreviousState,
+		ECellState NewState,
+		const TTopology& Topology);
+
+	/** Remembers a cell whose state changed, for subscribers following the board incrementally */
+	void RecordChangedCell(int32 Idx);
+
+	/** Notifies the grid got redrawn and which cells changed since previous notification */
+	void NotifyGridChanged();
+
+	/** Neighbor mine count of a cell, counted and cached upon first use when counting lazily */
+	template <typename TTopology>
+	int32 EnsureNeighborMineCount(int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology);
 
 	/** Examines current game state */
-	void UpdateGameState();
+	template <typename TTopology>
+	void UpdateGameState(const TTopology& Topology);
+
+	/** Labels zero regions once mines are placed, using the neighborhood of the configured topology. None when counting lazily */
+	void BuildZeroRegions();
+
+	/** Measures difficulty of the board once mines are placed, in one pass over it. None when counting lazily */
+	void CalculateBoardMetrics();
+
+	/** Changes state of a cell, recording the change for undo and in the summary of its tile */
+	template <typename TTopology>
+	void SetCellState(int32 Idx, const typename TTopology::FPosition& Pos, ECellState NewState, const TTopology& Topology);
 
 private:
 	struct FMinesweeperModel* Model;
+
+	/** Whether mines are yet to be placed upon the first visit of a no-guess game */
+	bool bIsMinePlacementPending;
+
+	/** Cell mines got placed around once a no-guess game got its first visit, INDEX_NONE until then and for other games */
+	int32 MinePlacementIdx;
+
+	/** Whether neighbor mine counts get computed upon reveal, in which case zero regions are not labeled */
+	bool bIsCountingLazily;
+
+	/** Cells whose neighbor mine count has been computed, when counting lazily */
+	TArrayView<bool> CountedCells;
+
+	/** Cell of a cascade, with its input position so that its neighbors take no division to find */
+	struct FCascadeCell
+	{
+		int32      Idx;
+		FIntVector Pos;
+	};
+
+	/** Cascade frontier, cells before CascadeHead have been visited. Kept between slices of a budgeted cascade */
+	TArray<FCascadeCell> CascadeQueue;
+	int32                CascadeHead;
+
+	/** Flagged cells the cascade passed through without revealing them, so that each gets queued once */
+	TSet<int32> CascadeFlaggedCells;
+
+	/** Player inputs waiting for the cascade in progress to complete */
+	TArray<FPlayerInput> QueuedInputs;
+
+	class FMinesweeperLatencyStats* LatencyStats;
+
+	/** Clock of the current game, zero until its first move */
+	double GameStartSeconds;
+	int32  MoveCount;
+	bool   bIsGameRecorded;
+
+	/** Cells changed since the grid was last notified, only gathered while anyone subscribes to them */
+	TArray<int32> ChangedCells;
+
+	bool                       bIsCascadeTickedExternally;
+	FTSTicker::FDelegateHandle CascadeTickerHandle;
+
+	/** Zero regions of the current board, labeled once mines are placed */
+	FMinesweeperZeroRegions ZeroRegions;
+
+	/** Which tiles of the current board are fully revealed or hold mines, summarized once mines are placed */
+	FMinesweeperTileSummaries TileSummaries;
+
+	FMinesweeperFrontier Frontier;
 };
\ No newline at end of file
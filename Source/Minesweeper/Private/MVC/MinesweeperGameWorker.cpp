@@ -0,0 +1,160 @@
+#include "MinesweeperGameWorker.h"
+#include "MinesweeperController.h"
+#include "MinesweeperModel.h"
+#include "HAL/RunnableThread.h"
+
+FMinesweeperGameWorker::FMinesweeperGameWorker(FMinesweeperModel* InModel, FMinesweeperController* InController) :
+	Model{InModel},
+	Controller{InController},
+	WakeUpEvent{FPlatformProcess::GetSynchEventFromPool(false)},
+	Thread{nullptr},
+	bIsStopRequested{false},
+	GameId{0},
+	PendingSlot{2},
+	WriteSlot{0},
+	ReadSlot{1}
+{
+	for (TSharedPtr<FMinesweeperSnapshot, ESPMode::ThreadSafe>& Slot : Slots)
+	{
+		Slot = MakeShared<FMinesweeperSnapshot, ESPMode::ThreadSafe>();
+	}
+
+	// Cascades over budget continue between commands on this thread instead of the game thread ticker
+	Controller->SetCascadeTickedExternally(true);
+
+	// Controller notifies on the worker thread, so both notifications end up as snapshots
+	Model->OnGameConfigUpdated.BindLambda([this](FMinesweeperGameConfig)
+	{
+		++GameId;
+		PublishSnapshot();
+	});
+	Model->OnMineGridChanged.BindLambda([this](FMinesweeperGameConfig, const FMinesweeperGameState&)
+	{
+		PublishSnapshot();
+	});
+
+	Thread = FRunnableThread::Create(this, TEXT("MinesweeperGameWorker"));
+}
+
+FMinesweeperGameWorker::~FMinesweeperGameWorker()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+	}
+
+	Model->OnGameConfigUpdated.Unbind();
+	Model->OnMineGridChanged.Unbind();
+	FPlatformProcess::ReturnSynchEventToPool(WakeUpEvent);
+}
+
+void FMinesweeperGameWorker::EnqueueStartNewGame(FMinesweeperGameConfig NewConfig)
+{
+	Enqueue({ECommandType::StartNewGame, FPlayerInput{}, NewConfig});
+}
+
+void FMinesweeperGameWorker::EnqueuePlayerInput(FPlayerInput Input)
+{
+	Enqueue({ECommandType::PlayerInput, Input, FMinesweeperGameConfig{}});
+}
+
+void FMinesweeperGameWorker::EnqueueUndoMove()
+{
+	Enqueue({ECommandType::UndoMove, FPlayerInput{}, FMinesweeperGameConfig{}});
+}
+
+void FMinesweeperGameWorker::EnqueueRedoMove()
+{
+	Enqueue({ECommandType::RedoMove, FPlayerInput{}, FMinesweeperGameConfig{}});
+}
+
+FMinesweeperSnapshotPtr FMinesweeperGameWorker::ConsumeSnapshot()
+{
+	if ((PendingSlot.load(std::memory_order_acquire) & SLOT_DIRTY_FLAG) == 0)
+	{
+		return nullptr;
+	}
+
+	ReadSlot = PendingSlot.exchange(ReadSlot, std::memory_order_acq_rel) & SLOT_INDEX_MASK;
+	return Slots[ReadSlot];
+}
+
+uint32 FMinesweeperGameWorker::Run()
+{
+	while (!bIsStopRequested.load())
+	{
+		FCommand Command;
+		while (Commands.Dequeue(Command))
+		{
+			ProcessCommand(Command);
+		}
+
+		// Every slice publishes a snapshot of the wavefront, commands get a chance in between
+		if (Controller->IsCascadeInProgress())
+		{
+			Controller->ContinueCascade();
+			continue;
+		}
+
+		WakeUpEvent->Wait();
+	}
+
+	return 0;
+}
+
+void FMinesweeperGameWorker::Stop()
+{
+	bIsStopRequested.store(true);
+	WakeUpEvent->Trigger();
+}
+
+void FMinesweeperGameWorker::Enqueue(FCommand Command)
+{
+	Commands.Enqueue(MoveTemp(Command));
+	WakeUpEvent->Trigger();
+}
+
+void FMinesweeperGameWorker::ProcessCommand(const FCommand& Command)
+{
+	switch (Command.Type)
+	{
+	case ECommandType::StartNewGame:
+		Controller->HandleOnStartNewGame(Command.Config);
+		break;
+	case ECommandType::PlayerInput:
+		Controller->HandleOnPlayerInput(Command.Input);
+		break;
+	case ECommandType::UndoMove:
+		Controller->HandleOnUndoMove();
+		break;
+	case ECommandType::RedoMove:
+		Controller->HandleOnRedoMove();
+		break;
+	}
+}
+
+void FMinesweeperGameWorker::PublishSnapshot()
+{
+	// Only this thread and the game thread hold slots, and the game thread no longer reaches this one through the
+	// triple buffer. Once it let go of its last reference, the slot and its allocation are free to reuse
+	if (!Slots[WriteSlot].IsUnique())
+	{
+		Slots[WriteSlot] = MakeShared<FMinesweeperSnapshot, ESPMode::ThreadSafe>();
+	}
+
+	FMinesweeperSnapshot& Snapshot = *Slots[WriteSlot];
+	const FMinesweeperGameState& GameState = Model->GameState;
+
+	Snapshot.GameId = GameId;
+	Snapshot.GameConfig = Model->GameConfig;
+	Snapshot.GameState.State = GameState.State;
+	Snapshot.GameState.RemainingMineCount = GameState.RemainingMineCount;
+	Snapshot.GameState.BoardMetrics = GameState.BoardMetrics;
+
+	// Reusing the allocation of the slot, it only grows when a bigger board starts
+	Snapshot.GameState.Cells.Reset();
+	Snapshot.GameState.Cells.Append(GameState.Cells);
+
+	WriteSlot = PendingSlot.exchange(WriteSlot | SLOT_DIRTY_FLAG, std::memory_order_acq_rel) & SLOT_INDEX_MASK;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperGame.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include <atomic>
+
+/** Copy of the game, published by the game worker after every processed command and immutable while anyone holds it */
+struct FMinesweeperSnapshot
+{
+	/** Increments whenever a new game starts, so that the view knows when to rebuild its layout */
+	uint32                 GameId;
+	FMinesweeperGameConfig GameConfig;
+	FMinesweeperGameState  GameState;
+};
+
+/** Keeps the snapshot alive and untouched for as long as it is held, however many snapshots get published meanwhile */
+using FMinesweeperSnapshotPtr = TSharedPtr<const FMinesweeperSnapshot, ESPMode::ThreadSafe>;
+
+/**
+ * Runs the minesweeper controller on a dedicated thread. Designed for:
+ * 1. Accepting commands from the game thread through a lock-free queue, never blocking Slate.
+ * 2. Publishing a snapshot of the model after each command through a lock-free triple buffer, whose three
+ *    slots keep their allocations so that publishing copies the board in place. A slot still held by the
+ *    game thread is left to its holder and replaced by a new snapshot instead of being written to.
+ * Game thread picks up the latest snapshot upon its next tick, skipping any it was too slow to see.
+ */
+class FMinesweeperGameWorker : public FRunnable
+{
+public:
+	FMinesweeperGameWorker(struct FMinesweeperModel* InModel, class FMinesweeperController* InController);
+	virtual ~FMinesweeperGameWorker() override;
+
+	FMinesweeperGameWorker(const FMinesweeperGameWorker&) = delete;
+	FMinesweeperGameWorker& operator=(const FMinesweeperGameWorker&) = delete;
+
+	void EnqueueStartNewGame(FMinesweeperGameConfig NewConfig);
+	void EnqueuePlayerInput(FPlayerInput Input);
+	void EnqueueUndoMove();
+	void EnqueueRedoMove();
+
+	/** Game thread only. Returns the snapshot published since last call, or null if there is none */
+	FMinesweeperSnapshotPtr ConsumeSnapshot();
+
+	/** FRunnable implementation */
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	enum class ECommandType : uint8
+	{
+		StartNewGame,
+		PlayerInput,
+		UndoMove,
+		RedoMove,
+	};
+
+	struct FCommand
+	{
+		ECommandType           Type;
+		FPlayerInput           Input;
+		FMinesweeperGameConfig Config;
+	};
+
+	void Enqueue(FCommand Command);
+	void ProcessCommand(const FCommand& Command);
+
+	/** Worker thread only. Copies the model into the write slot and hands it over to the game thread */
+	void PublishSnapshot();
+
+private:
+	struct FMinesweeperModel*    Model;
+	class FMinesweeperController* Controller;
+
+	TQueue<FCommand, EQueueMode::Mpsc> Commands;
+	FEvent*                            WakeUpEvent;
+	FRunnableThread*                   Thread;
+	std::atomic<bool>                  bIsStopRequested;
+
+	/** Worker thread only */
+	uint32 GameId;
+
+	/**
+	 * Triple buffer of snapshots. Worker owns WriteSlot, game thread owns ReadSlot, and they swap
+	 * their slot with the pending one. The dirty flag tells whether pending slot holds a new snapshot.
+	 */
+	static constexpr uint32 SLOT_INDEX_MASK = 0x3;
+	static constexpr uint32 SLOT_DIRTY_FLAG = 0x4;
+
+	TSharedPtr<FMinesweeperSnapshot, ESPMode::ThreadSafe> Slots[3];
+	std::atomic<uint32>     PendingSlot;
+	uint32                  WriteSlot;
+	uint32                  ReadSlot;
+};
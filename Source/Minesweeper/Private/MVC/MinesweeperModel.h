@@ -2,23 +2,38 @@
 
 #include "CoreMinimal.h"
 #include "MinesweeperGame.h"
+#include "MinesweeperGameArena.h"
+#include "MinesweeperJournal.h"
 
 DECLARE_DELEGATE_OneParam(FOnGameConfigUpdated, FMinesweeperGameConfig)
 DECLARE_DELEGATE_TwoParams(FOnMineGridChanged, FMinesweeperGameConfig, const FMinesweeperGameState&)
+DECLARE_DELEGATE_TwoParams(FOnGameStarted, FMinesweeperGameConfig, const FMinesweeperGameState&)
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnCellsChanged, const FMinesweeperGameState&, TConstArrayView<int32>)
+DECLARE_DELEGATE_OneParam(FOnGameFinished, const FMinesweeperGameRecord&)
 
 /**
  * Model of minesweeper editor window in MVC pattern.
  * This is the minimum amount of data contained for the editor state.
  * Also defined two delegates that notifies the subscribers when either
  * game config is updated or mine grid needs redrawing.
+ * Subscribers following the board incrementally get notified of every new game
+ * and of the cells changed since previous notification instead, ahead of the redraw.
+ * Every game gets reported once when it is first over, for keeping statistics.
+ * The journal holds the undo and redo history of the current game.
+ * The arena holds the per-game buffers derived from the board, released all at once upon a new game.
  */
 struct FMinesweeperModel
 {
 	FOnGameConfigUpdated OnGameConfigUpdated;
 	FOnMineGridChanged   OnMineGridChanged;
+	FOnGameStarted       OnGameStarted;
+	FOnCellsChanged      OnCellsChanged;
+	FOnGameFinished      OnGameFinished;
 
 	FMinesweeperGameConfig GameConfig;
 	FMinesweeperGameState  GameState;
+	FMinesweeperJournal    Journal;
+	FMinesweeperGameArena  Arena;
 
 	FMinesweeperModel() :
 		GameConfig{FMinesweeperGameConfig::MakeDefaultConfig()},
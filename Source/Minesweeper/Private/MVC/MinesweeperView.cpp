@@ -3,7 +3,15 @@
 
 #include "MinesweeperView.h"
 #include "MinesweeperGame.h"
+#include "MinesweeperGrid.h"
+#include "MinesweeperLatencyStats.h"
+#include "MinesweeperStatsStore.h"
+#include "Solver/MinesweeperProbabilityAnalyzer.h"
+#include "Widgets/Input/SCheckBox.h"
+#include "Widgets/Input/SComboBox.h"
 #include "Widgets/Layout/SUniformGridPanel.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
 
 #define LOCTEXT_NAMESPACE "FMinesweeperView"
 
@@ -15,6 +23,7 @@ namespace
 		static const FLinearColor ExplodedMineColor = FLinearColor::Red;
 		static const FLinearColor RevealedCellColor = FLinearColor::Gray;
 		static const FLinearColor HiddenCellColor = FLinearColor::White;
+		static const FLinearColor FlaggedCellColor = FLinearColor::Yellow;
 
 		FLinearColor Color;
 
@@ -34,6 +43,9 @@ namespace
 		case ECellState::Exploded:
 			Color = ExplodedMineColor;
 			break;
+		case ECellState::Flagged:
+			Color = FlaggedCellColor;
+			break;
 		case ECellState::Hidden:
 		default:
 			Color = HiddenCellColor;
@@ -62,17 +74,71 @@ namespace
 		const bool bIsRevealed = MineCell.IsRevealed();
 		const bool bHasText = !bIsMineCell && bIsRevealed;
 
+		if (MineCell.IsFlagged())
+		{
+			return FLinearColor::Red;
+		}
+
 		if (bHasText)
 		{
-			return TextColor[NeighborCellCount];
+			// Cube boards count up to 26 neighbors, every count beyond the table shares its last color
+			return TextColor[FMath::Min(NeighborCellCount, static_cast<int32>(UE_ARRAY_COUNT(TextColor)) - 1)];
 		}
 
 		return FLinearColor::Transparent;
 	}
+
+	FText GetTopologyDisplayName(ETopology Topology)
+	{
+		switch (Topology)
+		{
+		case ETopology::Torus:
+			return FText::FromString("Torus");
+		case ETopology::Hexagonal:
+			return FText::FromString("Hexagonal");
+		case ETopology::Cube:
+			return FText::FromString("Cube");
+		case ETopology::Square:
+		default:
+			return FText::FromString("Square");
+		}
+	}
+
+	FLinearColor GetMineProbabilityColor(float Probability)
+	{
+		static const FLinearColor SafeColor = FLinearColor::White;
+		static const FLinearColor DangerColor = FLinearColor{1.0F, 0.3F, 0.3F};
+
+		return FMath::Lerp(SafeColor, DangerColor, Probability);
+	}
+}
+
+FMinesweeperView::FMinesweeperView() :
+	CurrentConfig{FMinesweeperGameConfig::MakeDefaultConfig()},
+	CurrentState{EMinesweeperGameState::Running},
+	bIsCellKnowledgeStale{true},
+	DisplayedLayer{0},
+	ProbabilityAnalyzer{MakeUnique<FMinesweeperProbabilityAnalyzer>()},
+	SubmittedRevision{0},
+	AppliedRevision{0},
+	LatencyStats{nullptr},
+	StatsStore{nullptr},
+	DisplayedStatsRevision{0},
+	DisplayedGameId{0}
+{
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FMinesweeperView::Tick));
+
+	// Hexagonal boards need odd rows drawn shifted, which the uniform grid widget cannot do, so they are left out
+	for (const ETopology Topology : {ETopology::Square, ETopology::Torus, ETopology::Cube})
+	{
+		TopologyOptions.Add(MakeShared<ETopology>(Topology));
+	}
+	SelectedTopology = TopologyOptions[0];
 }
 
-FMinesweeperView::FMinesweeperView()
+FMinesweeperView::~FMinesweeperView()
 {
+	FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
 }
 
 TSharedRef<SDockTab> FMinesweeperView::CreateMinesweeperView(
@@ -100,6 +166,28 @@ TSharedRef<SDockTab> FMinesweeperView::CreateMinesweeperView(
 				[
 					InputWidget.ToSharedRef()
 				]
+				+ SVerticalBox::Slot()
+				  .HAlign(HAlign_Left)
+				  .VAlign(VAlign_Top)
+				  .AutoHeight()
+				  .Padding(10.0F)
+				[
+					SAssignNew(RemainingMinesWidget, STextBlock)
+					.Font(FSlateFontInfo(FPaths::EngineContentDir() / TEXT("Slate/Fonts/Roboto-Regular.ttf"), 12))
+				]
+				+ SVerticalBox::Slot()
+				  .HAlign(HAlign_Left)
+				  .VAlign(VAlign_Top)
+				  .AutoHeight()
+				  .Padding(10.0F)
+				[
+					SAssignNew(StatsWidget, STextBlock)
+					.Visibility_Lambda([this]()
+					{
+						return StatsStore != nullptr ? EVisibility::Visible : EVisibility::Collapsed;
+					})
+					.Font(FSlateFontInfo(FPaths::EngineContentDir() / TEXT("Slate/Fonts/Roboto-Regular.ttf"), 12))
+				]
 				+ SVerticalBox::Slot()
 				  .HAlign(HAlign_Left)
 				  .VAlign(VAlign_Top)
@@ -117,10 +205,25 @@ TSharedRef<SDockTab> FMinesweeperView::CreateMinesweeperView(
 				[
 					MineGridWidget.ToSharedRef()
 				]
+				+ SVerticalBox::Slot()
+				  .HAlign(HAlign_Left)
+				  .VAlign(VAlign_Top)
+				  .AutoHeight()
+				  .Padding(10.0F)
+				[
+					SAssignNew(LatencyWidget, STextBlock)
+					.Visibility_Lambda([this]()
+					{
+						return IsLatencyOverlayEnabled() ? EVisibility::Visible : EVisibility::Collapsed;
+					})
+					.Font(FSlateFontInfo(FPaths::EngineContentDir() / TEXT("Slate/Fonts/DroidSansMono.ttf"), 10))
+				]
 			]
 		];
 
 	RebuildMineGridWidget(GameConfig);
+	UpdateRemainingMinesWidget(GameConfig.MineCount);
+	UpdateStatsWidget();
 
 	return DockTab.ToSharedRef();
 }
@@ -190,6 +293,39 @@ TSharedPtr<SWidget> FMinesweeperView::CreateInputWidget()
 					ValidateMineCountInput();
 				})
 			]
+			+ SHorizontalBox::Slot()
+			  .Padding(20.0F, 0.0F, 0.0F, 0.0F)
+			  .AutoWidth()
+			  .HAlign(HAlign_Left)
+			  .VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.MinDesiredWidth(50.0F)
+				.Text(FText::FromString("Depth: "))
+				.Font(FSlateFontInfo(FPaths::EngineContentDir() / TEXT("Slate/Fonts/Roboto-Regular.ttf"), 12))
+			]
+			+ SHorizontalBox::Slot()
+			  .AutoWidth()
+			  .HAlign(HAlign_Center)
+			  .VAlign(VAlign_Center)
+			[
+				SAssignNew(DepthSpinBox, SSpinBox<int32>)
+				.MinDesiredWidth(100.0F)
+				.MinValue(FMinesweeperGameConfig::MIN_DEPTH)
+				.MaxValue(FMinesweeperGameConfig::MAX_DEPTH)
+				.MinSliderValue(FMinesweeperGameConfig::MIN_DEPTH)
+				.MaxSliderValue(FMinesweeperGameConfig::MAX_DEPTH)
+				.Value(FMinesweeperGameConfig::MIN_DEPTH)
+				.Delta(1)
+				.IsEnabled_Lambda([this]()
+				{
+					return *SelectedTopology == ETopology::Cube;
+				})
+				.OnValueChanged_Lambda([this](int32)
+				{
+					ValidateMineCountInput();
+				})
+			]
 		]
 		+ SVerticalBox::Slot()
 		  .Padding(0.0F, 10.0F)
@@ -220,18 +356,195 @@ TSharedPtr<SWidget> FMinesweeperView::CreateInputWidget()
 				.Value(FMinesweeperGameConfig::DEFAULT_MINE_COUNT)
 				.Delta(1)
 			]
+			+ SHorizontalBox::Slot()
+			  .Padding(20.0F, 0.0F, 0.0F, 0.0F)
+			  .AutoWidth()
+			  .HAlign(HAlign_Left)
+			  .VAlign(VAlign_Center)
+			[
+				SAssignNew(NoGuessCheckBox, SCheckBox)
+				.IsChecked(ECheckBoxState::Unchecked)
+				.OnCheckStateChanged_Lambda([this](ECheckBoxState)
+				{
+					ValidateMineCountInput();
+				})
+				[
+					SNew(STextBlock)
+					.Text(FText::FromString("No Guess"))
+					.Font(FSlateFontInfo(FPaths::EngineContentDir() / TEXT("Slate/Fonts/Roboto-Regular.ttf"), 12))
+				]
+			]
+			+ SHorizontalBox::Slot()
+			  .Padding(20.0F, 0.0F, 0.0F, 0.0F)
+			  .AutoWidth()
+			  .HAlign(HAlign_Left)
+			  .VAlign(VAlign_Center)
+			[
+				SNew(SComboBox<TSharedPtr<ETopology>>)
+				.OptionsSource(&TopologyOptions)
+				.InitiallySelectedItem(SelectedTopology)
+				.OnGenerateWidget_Lambda([](TSharedPtr<ETopology> Option)
+				{
+					return SNew(STextBlock).Text(GetTopologyDisplayName(*Option));
+				})
+				.OnSelectionChanged_Lambda([this](TSharedPtr<ETopology> Option, ESelectInfo::Type)
+				{
+					if (Option.IsValid())
+					{
+						SelectedTopology = Option;
+						ValidateMineCountInput();
+					}
+				})
+				[
+					SNew(STextBlock)
+					.Text_Lambda([this]()
+					{
+						return GetTopologyDisplayName(*SelectedTopology);
+					})
+					.Font(FSlateFontInfo(FPaths::EngineContentDir() / TEXT("Slate/Fonts/Roboto-Regular.ttf"), 12))
+				]
+			]
+		]
+		+ SVerticalBox::Slot()
+		  .Padding(0.0F, 10.0F)
+		  .HAlign(HAlign_Left)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			  .AutoWidth()
+			[
+				SAssignNew(NewGameButton, SButton)
+				.Text(FText::FromString("Start New Game"))
+				.OnClicked_Lambda([this]()
+				{
+					BroadcastOnStartNewGame();
+					return FReply::Handled();
+				})
+			]
+			+ SHorizontalBox::Slot()
+			  .Padding(20.0F, 0.0F, 0.0F, 0.0F)
+			  .AutoWidth()
+			[
+				SNew(SButton)
+				.Text(FText::FromString("Undo"))
+				.OnClicked_Lambda([this]()
+				{
+					OnUndoMove.ExecuteIfBound();
+					return FReply::Handled();
+				})
+			]
+			+ SHorizontalBox::Slot()
+			  .Padding(10.0F, 0.0F, 0.0F, 0.0F)
+			  .AutoWidth()
+			[
+				SNew(SButton)
+				.Text(FText::FromString("Redo"))
+				.OnClicked_Lambda([this]()
+				{
+					OnRedoMove.ExecuteIfBound();
+					return FReply::Handled();
+				})
+			]
 		]
 		+ SVerticalBox::Slot()
 		  .Padding(0.0F, 10.0F)
 		  .HAlign(HAlign_Left)
 		[
-			SAssignNew(NewGameButton, SButton)
-			.Text(FText::FromString("Start New Game"))
-			.OnClicked_Lambda([this]()
+			SAssignNew(ProbabilityCheckBox, SCheckBox)
+			.IsChecked(ECheckBoxState::Unchecked)
+			.OnCheckStateChanged_Lambda([this](ECheckBoxState NewState)
 			{
-				BroadcastOnStartNewGame();
-				return FReply::Handled();
+				if (NewState == ECheckBoxState::Checked)
+				{
+					SubmitProbabilitySnapshot();
+				}
+				else
+				{
+					ClearProbabilityOverlay();
+				}
 			})
+			[
+				SNew(STextBlock)
+				.Text(FText::FromString("Show Mine Probability"))
+				.Font(FSlateFontInfo(FPaths::EngineContentDir() / TEXT("Slate/Fonts/Roboto-Regular.ttf"), 12))
+			]
+		]
+		+ SVerticalBox::Slot()
+		  .Padding(0.0F, 10.0F)
+		  .HAlign(HAlign_Left)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			  .AutoWidth()
+			  .HAlign(HAlign_Left)
+			  .VAlign(VAlign_Center)
+			[
+				SAssignNew(LatencyCheckBox, SCheckBox)
+				.IsChecked(ECheckBoxState::Unchecked)
+				.OnCheckStateChanged_Lambda([this](ECheckBoxState)
+				{
+					UpdateLatencyOverlay();
+				})
+				[
+					SNew(STextBlock)
+					.Text(FText::FromString("Show Move Latency"))
+					.Font(FSlateFontInfo(FPaths::EngineContentDir() / TEXT("Slate/Fonts/Roboto-Regular.ttf"), 12))
+				]
+			]
+			+ SHorizontalBox::Slot()
+			  .Padding(20.0F, 0.0F, 0.0F, 0.0F)
+			  .AutoWidth()
+			[
+				SNew(SButton)
+				.Text(FText::FromString("Export Latency CSV"))
+				.IsEnabled_Lambda([this]()
+				{
+					return LatencyStats != nullptr;
+				})
+				.OnClicked_Lambda([this]()
+				{
+					ExportLatencyStats();
+					return FReply::Handled();
+				})
+			]
+		]
+		+ SVerticalBox::Slot()
+		  .Padding(0.0F, 10.0F)
+		  .HAlign(HAlign_Left)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			  .AutoWidth()
+			  .HAlign(HAlign_Left)
+			  .VAlign(VAlign_Center)
+			[
+				SNew(STextBlock)
+				.MinDesiredWidth(50.0F)
+				.Text(FText::FromString("Layer: "))
+				.Font(FSlateFontInfo(FPaths::EngineContentDir() / TEXT("Slate/Fonts/Roboto-Regular.ttf"), 12))
+			]
+			+ SHorizontalBox::Slot()
+			  .AutoWidth()
+			  .HAlign(HAlign_Center)
+			  .VAlign(VAlign_Center)
+			[
+				SAssignNew(LayerSpinBox, SSpinBox<int32>)
+				.MinDesiredWidth(100.0F)
+				.MinValue(0)
+				.MaxValue(0)
+				.MinSliderValue(0)
+				.MaxSliderValue(0)
+				.Value(0)
+				.Delta(1)
+				.IsEnabled_Lambda([this]()
+				{
+					return CurrentConfig.GridDepth > 1;
+				})
+				.OnValueChanged_Lambda([this](int32 NewLayer)
+				{
+					SetDisplayedLayer(NewLayer);
+				})
+			]
 		];
 }
 
@@ -239,31 +552,63 @@ void FMinesweeperView::RebuildGameLayout(FMinesweeperGameConfig NewConfig)
 {
 	RebuildMineGridWidget(NewConfig);
 	UpdateGameStateWidget(EMinesweeperGameState::Running);
+	UpdateRemainingMinesWidget(NewConfig.MineCount);
+	UpdateStatsWidget();
+	SubmitProbabilitySnapshot();
+	UpdateLatencyOverlay();
 }
 
 void FMinesweeperView::UpdateGameLayout(FMinesweeperGameConfig GameConfig, const FMinesweeperGameState& GameState)
 {
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
 	UpdateMineGridWidget(GameConfig, GameState);
 	UpdateGameStateWidget(GameState.State);
+	UpdateRemainingMinesWidget(GameState.RemainingMineCount);
+
+	if (LatencyStats)
+	{
+		LatencyStats->RecordViewTime(StartCycles, FPlatformTime::Cycles64());
+		UpdateLatencyOverlay();
+	}
+
+	// Keep showing the previous probabilities on cells still hidden until the new result lands
+	if (IsProbabilityOverlayEnabled() && CurrentState == EMinesweeperGameState::Running)
+	{
+		if (const FMinesweeperProbabilityAnalyzer::FResultPtr Result = ProbabilityAnalyzer->GetLatestResult())
+		{
+			ApplyProbabilityOverlay(*Result);
+		}
+	}
+	SubmitProbabilitySnapshot();
 }
 
-void FMinesweeperView::BroadcastOnStartNewGame()
+FMinesweeperGameConfig FMinesweeperView::MakeGameConfigFromInput() const
 {
 	const int32 GridWidth = WidthSpinBox->GetValueAttribute().Get();
 	const int32 GridHeight = HeightSpinBox->GetValueAttribute().Get();
 	const int32 MineCount = MineCountSpinBox->GetValueAttribute().Get();
 	const TOptional<int32> Seed{};
-	const FMinesweeperGameConfig NewConfig{{GridWidth, GridHeight}, MineCount, Seed};
+	const EMineGeneration Generation = NoGuessCheckBox->IsChecked() ? EMineGeneration::NoGuess : EMineGeneration::Random;
+
+	const ETopology Topology = *SelectedTopology;
+	const int32 GridDepth = Topology == ETopology::Cube ? DepthSpinBox->GetValueAttribute().Get() : 1;
+
+	return FMinesweeperGameConfig{{GridWidth, GridHeight}, MineCount, Seed, Generation, Topology, GridDepth};
+}
+
+void FMinesweeperView::BroadcastOnStartNewGame()
+{
+	const FMinesweeperGameConfig NewConfig = MakeGameConfigFromInput();
 
 	OnStartNewGame.ExecuteIfBound(NewConfig);
 }
 
 void FMinesweeperView::ValidateMineCountInput()
 {
-	const int32 GridWidth = WidthSpinBox->GetValueAttribute().Get();
-	const int32 GridHeight = HeightSpinBox->GetValueAttribute().Get();
-	const int32 MineCount = MineCountSpinBox->GetValueAttribute().Get();
-	const int32 MaxMineCount = GridWidth * GridHeight - 1;
+	const FMinesweeperGameConfig InputConfig = MakeGameConfigFromInput();
+	const int32 MineCount = InputConfig.MineCount;
+	const int32 MaxMineCount = InputConfig.GetMaxMineCount();
 	const int32 NewMineCount = FMath::Min(MineCount, MaxMineCount);
 
 	MineCountSpinBox->SetMaxValue(MaxMineCount);
@@ -275,50 +620,123 @@ void FMinesweeperView::RebuildMineGridWidget(FMinesweeperGameConfig GameConfig)
 {
 	const int32 GridWidth = GameConfig.GridSize.X;
 	const int32 GridHeight = GameConfig.GridSize.Y;
-	const int32 CellCount = GridWidth * GridHeight;
+	const int32 LayerCellCount = GridWidth * GridHeight;
 
 	MineGridWidget->ClearChildren();
 	MineCellWidgets.Empty();
-	MineCellWidgets.Reserve(CellCount);
+	MineCellWidgets.Reserve(LayerCellCount);
+
+	CurrentConfig = GameConfig;
+	CurrentState = EMinesweeperGameState::Running;
+	CurrentCells = {};
+	bIsCellKnowledgeStale = true;
 
-	for (int32 Idx = 0; Idx < CellCount; ++Idx)
+	// Rows and columns come from the loops rather than dividing every widget index
+	for (int32 Y = 0; Y < GridHeight; ++Y)
 	{
-		const int32 X = Idx % GridWidth;
-		const int32 Y = Idx / GridWidth;
-		const FIntPoint Coordinate{X, Y};
+		for (int32 X = 0; X < GridWidth; ++X)
+		{
+			SUniformGridPanel::FSlot& Slot = MineGridWidget->AddSlot(X, Y);
+			FMineCellWidget& MineCellWidget = MineCellWidgets.Emplace_GetRef();
+			MineCellWidget.OnWidgetClicked.BindLambda([this, X, Y]()
+			{
+				const FPlayerInput Input{FIntVector{X, Y, DisplayedLayer}, EInputType::Visit, FPlatformTime::Cycles64()};
+				OnPlayerInput.ExecuteIfBound(Input);
+			});
+			MineCellWidget.OnWidgetRightClicked.BindLambda([this, X, Y]()
+			{
+				const FPlayerInput Input{FIntVector{X, Y, DisplayedLayer}, EInputType::Flag, FPlatformTime::Cycles64()};
+				OnPlayerInput.ExecuteIfBound(Input);
+			});
+
+			Slot.AttachWidget(MineCellWidget.GetWidget());
+		}
+	}
 
-		SUniformGridPanel::FSlot& Slot = MineGridWidget->AddSlot(X, Y);
-		FMineCellWidget& MineCellWidget = MineCellWidgets.Emplace_GetRef();
-		MineCellWidget.OnWidgetClicked.BindLambda([this, Coordinate]()
+	// Only one layer of a cube board is on screen at a time
+	const int32 MaxLayer = GameConfig.GridDepth - 1;
+	LayerSpinBox->SetMaxValue(MaxLayer);
+	LayerSpinBox->SetMaxSliderValue(MaxLayer);
+	LayerSpinBox->SetValue(0);
+	DisplayedLayer = INDEX_NONE;
+	SetDisplayedLayer(0);
+}
+
+void FMinesweeperView::SetDisplayedLayer(int32 NewLayer)
+{
+	const int32 Layer = FMath::Clamp(NewLayer, 0, CurrentConfig.GridDepth - 1);
+	if (Layer == DisplayedLayer)
+	{
+		return;
+	}
+
+	DisplayedLayer = Layer;
+
+	const FIntPoint GridSize = CurrentConfig.GridSize;
+	WidgetCellIndices.Reset(MineCellWidgets.Num());
+	MinesweeperGrid::DispatchTopology(CurrentConfig, [this, GridSize, Layer](const auto& Topology)
+	{
+		// Widgets are laid out row by row
+		for (int32 Y = 0; Y < GridSize.Y; ++Y)
 		{
-			const FPlayerInput Input{Coordinate, EInputType::Visit};
-			OnPlayerInput.ExecuteIfBound(Input);
-		});
+			for (int32 X = 0; X < GridSize.X; ++X)
+			{
+				WidgetCellIndices.Add(Topology.GetCellIndex(Topology.MakePosition(FIntVector{X, Y, Layer})));
+			}
+		}
+	});
 
-		Slot.AttachWidget(MineCellWidget.GetWidget());
+	DrawDisplayedLayer();
+	if (IsProbabilityOverlayEnabled() && CurrentState == EMinesweeperGameState::Running)
+	{
+		if (const FMinesweeperProbabilityAnalyzer::FResultPtr Result = ProbabilityAnalyzer->GetLatestResult())
+		{
+			ApplyProbabilityOverlay(*Result);
+		}
 	}
 }
 
-void FMinesweeperView::UpdateMineGridWidget(FMinesweeperGameConfig GameConfig, const FMinesweeperGameState& GameState)
+void FMinesweeperView::DrawDisplayedLayer()
 {
-	const TArray<FMineCell>& MineCells = GameState.Cells;
-	const int32 GridWidth  = GameConfig.GridSize.X;
-	const int32 GridHeight = GameConfig.GridSize.Y;
-	const int32 CellCount  = GridWidth * GridHeight;
+	if (CurrentCells.Num() != CurrentConfig.GetCellCount())
+	{
+		return;
+	}
 
-	for (int32 Idx = 0; Idx < CellCount; ++Idx)
+	for (int32 WidgetIdx = 0; WidgetIdx < MineCellWidgets.Num(); ++WidgetIdx)
 	{
-		const FMineCell& MineCell = MineCells[Idx];
+		const FMineCell& MineCell = CurrentCells[WidgetCellIndices[WidgetIdx]];
 		const FLinearColor CellColor = GetMineCellColor(MineCell.CellState, MineCell.CellType);
 		const FLinearColor CellTextColor = GetMineCellTextColor(MineCell);
-		const FText CellText = FText::AsNumber(MineCell.NeighborMineCount);
+		const FText CellText = MineCell.IsFlagged() ? FText::FromString("F") : FText::AsNumber(MineCell.NeighborMineCount);
 
-		FMineCellWidget& MineCellWidget = MineCellWidgets[Idx];
+		FMineCellWidget& MineCellWidget = MineCellWidgets[WidgetIdx];
 		MineCellWidget.SetCellColor(CellColor);
 		MineCellWidget.SetCellText(CellText, CellTextColor);
 	}
 }
 
+void FMinesweeperView::UpdateMineGridWidget(FMinesweeperGameConfig GameConfig, const FMinesweeperGameState& GameState)
+{
+	CurrentState = GameState.State;
+	CurrentCells = GameState.Cells;
+
+	DrawDisplayedLayer();
+}
+
+void FMinesweeperView::HandleOnCellsChanged(const FMinesweeperGameState& GameState, TConstArrayView<int32> ChangedCells)
+{
+	// Nothing reads the knowledge with the overlay off, it gets rebuilt once when enabled again
+	if (bIsCellKnowledgeStale || !IsProbabilityOverlayEnabled())
+	{
+		bIsCellKnowledgeStale = true;
+		return;
+	}
+
+	// Knowledge of the cells is read upon submission, once the cells drawn are the ones of the model
+	ChangedKnowledgeCells.Append(ChangedCells);
+}
+
 void FMinesweeperView::UpdateGameStateWidget(EMinesweeperGameState State)
 {
 	switch (State)
@@ -337,4 +755,210 @@ void FMinesweeperView::UpdateGameStateWidget(EMinesweeperGameState State)
 	}
 }
 
-#undef LOCTEXT_NAMESPACE
\ No newline at end of file
+void FMinesweeperView::UpdateRemainingMinesWidget(int32 RemainingMineCount)
+{
+	RemainingMinesWidget->SetText(FText::FromString(FString::Printf(TEXT("Mines Left: %d"), RemainingMineCount)));
+}
+
+void FMinesweeperView::UpdateStatsWidget()
+{
+	if (!StatsStore || !StatsWidget.IsValid())
+	{
+		return;
+	}
+
+	DisplayedStatsRevision = StatsStore->GetRevision();
+
+	const FMinesweeperConfigStats Stats = StatsStore->GetStats(CurrentConfig);
+	const FString BestTime = Stats.HasWin() ? FString::Printf(TEXT("%.2f s"), Stats.BestWinMilliseconds / 1000.0) : TEXT("-");
+	StatsWidget->SetText(FText::FromString(FString::Printf(TEXT("Best Time: %s   Won: %u of %u (%.0f%%)"),
+		*BestTime, Stats.WinCount, Stats.GameCount, Stats.GetWinRate() * 100.0)));
+}
+
+bool FMinesweeperView::IsFlaggedCell(int32 Idx) const
+{
+	// Flags are the player's guesses, the analyzer sees them as hidden but the overlay leaves them be
+	return CurrentCells.IsValidIndex(Idx) && CurrentCells[Idx].IsFlagged();
+}
+
+bool FMinesweeperView::IsHiddenCell(int32 Idx) const
+{
+	// Mines only get revealed once the game is lost, the analyzer has nothing to learn from them
+	return CurrentCells.IsValidIndex(Idx) && (!CurrentCells[Idx].IsRevealed() || CurrentCells[Idx].IsMine());
+}
+
+int8 FMinesweeperView::GetCellKnowledge(int32 Idx) const
+{
+	// Cells of a board not drawn yet are all hidden
+	if (!CurrentCells.IsValidIndex(Idx) || IsHiddenCell(Idx))
+	{
+		return FMinesweeperProbabilityAnalyzer::HIDDEN_CELL;
+	}
+	return static_cast<int8>(CurrentCells[Idx].NeighborMineCount);
+}
+
+bool FMinesweeperView::Tick(float DeltaTime)
+{
+	PollSnapshot();
+
+	// Finished games reach the store on its own thread, so the widget follows its revision
+	if (StatsStore && StatsStore->GetRevision() != DisplayedStatsRevision)
+	{
+		UpdateStatsWidget();
+	}
+
+	// Pick up the result of the latest snapshot once the analyzer has it, never waiting for it
+	if (IsProbabilityOverlayEnabled() && CurrentState == EMinesweeperGameState::Running && AppliedRevision != SubmittedRevision)
+	{
+		const FMinesweeperProbabilityAnalyzer::FResultPtr Result = ProbabilityAnalyzer->GetLatestResult();
+		if (Result && Result->Revision == SubmittedRevision)
+		{
+			ApplyProbabilityOverlay(*Result);
+			AppliedRevision = Result->Revision;
+		}
+	}
+
+	return true;
+}
+
+void FMinesweeperView::PollSnapshot()
+{
+	if (!OnPollSnapshot.IsBound() || !MineGridWidget.IsValid())
+	{
+		return;
+	}
+
+	if (const FMinesweeperSnapshotPtr Snapshot = OnPollSnapshot.Execute())
+	{
+		if (Snapshot->GameId != DisplayedGameId)
+		{
+			DisplayedGameId = Snapshot->GameId;
+			RebuildGameLayout(Snapshot->GameConfig);
+		}
+		// Snapshots skip the boards in between, so the cells changed since the last one drawn are unknown
+		bIsCellKnowledgeStale = true;
+		UpdateGameLayout(Snapshot->GameConfig, Snapshot->GameState);
+
+		// Previous snapshot is let go only once the cells drawn no longer view it
+		DisplayedSnapshot = Snapshot;
+	}
+}
+
+void FMinesweeperView::SetLatencyStats(FMinesweeperLatencyStats* InLatencyStats)
+{
+	LatencyStats = InLatencyStats;
+}
+
+void FMinesweeperView::SetStatsStore(FMinesweeperStatsStore* InStatsStore)
+{
+	StatsStore = InStatsStore;
+}
+
+bool FMinesweeperView::IsProbabilityOverlayEnabled() const
+{
+	return ProbabilityCheckBox.IsValid() && ProbabilityCheckBox->IsChecked();
+}
+
+void FMinesweeperView::SubmitProbabilitySnapshot()
+{
+	if (!IsProbabilityOverlayEnabled() || CurrentState != EMinesweeperGameState::Running)
+	{
+		return;
+	}
+
+	// Whole board only when the changes since the last one are unknown, it is moved into the analyzer
+	if (bIsCellKnowledgeStale)
+	{
+		TArray<int8> Knowledge;
+		Knowledge.SetNumUninitialized(CurrentConfig.GetCellCount());
+		for (int32 Idx = 0; Idx < Knowledge.Num(); ++Idx)
+		{
+			Knowledge[Idx] = GetCellKnowledge(Idx);
+		}
+
+		SubmittedRevision = ProbabilityAnalyzer->SubmitBoard(CurrentConfig, MoveTemp(Knowledge));
+		bIsCellKnowledgeStale = false;
+	}
+	else if (ChangedKnowledgeCells.Num() > 0)
+	{
+		SubmittedRevision = ProbabilityAnalyzer->SubmitChanges(ChangedKnowledgeCells, [this](int32 Idx)
+		{
+			return GetCellKnowledge(Idx);
+		});
+	}
+
+	ChangedKnowledgeCells.Reset();
+}
+
+void FMinesweeperView::ApplyProbabilityOverlay(const FMinesweeperProbabilityResult& Result)
+{
+	if (Result.MineProbabilities.Num() != CurrentCells.Num())
+	{
+		return;
+	}
+
+	FNumberFormattingOptions FormattingOptions;
+	FormattingOptions.SetMaximumFractionalDigits(0);
+
+	for (int32 WidgetIdx = 0; WidgetIdx < MineCellWidgets.Num(); ++WidgetIdx)
+	{
+		const int32 Idx = WidgetCellIndices[WidgetIdx];
+		const float Probability = Result.MineProbabilities[Idx];
+		if (Probability >= 0.0F && IsHiddenCell(Idx) && !IsFlaggedCell(Idx))
+		{
+			FMineCellWidget& MineCellWidget = MineCellWidgets[WidgetIdx];
+			MineCellWidget.SetCellColor(GetMineProbabilityColor(Probability));
+			MineCellWidget.SetCellText(FText::AsPercent(Probability, &FormattingOptions), FLinearColor::Black);
+		}
+	}
+}
+
+void FMinesweeperView::ClearProbabilityOverlay()
+{
+	for (int32 WidgetIdx = 0; WidgetIdx < MineCellWidgets.Num(); ++WidgetIdx)
+	{
+		const int32 Idx = WidgetCellIndices[WidgetIdx];
+		if (IsHiddenCell(Idx) && CurrentState == EMinesweeperGameState::Running && !IsFlaggedCell(Idx))
+		{
+			FMineCellWidget& MineCellWidget = MineCellWidgets[WidgetIdx];
+			MineCellWidget.SetCellColor(GetMineCellColor(ECellState::Hidden, ECellType::Empty));
+			MineCellWidget.SetCellText(FText::GetEmpty(), FLinearColor::Transparent);
+		}
+	}
+
+	SubmittedRevision = 0;
+	AppliedRevision = 0;
+	ChangedKnowledgeCells.Reset();
+	bIsCellKnowledgeStale = true;
+}
+
+bool FMinesweeperView::IsLatencyOverlayEnabled() const
+{
+	return LatencyCheckBox.IsValid() && LatencyCheckBox->IsChecked() && LatencyStats != nullptr;
+}
+
+void FMinesweeperView::UpdateLatencyOverlay()
+{
+	if (IsLatencyOverlayEnabled() && LatencyWidget.IsValid())
+	{
+		LatencyWidget->SetText(FText::FromString(LatencyStats->ToSummaryString()));
+	}
+}
+
+void FMinesweeperView::ExportLatencyStats() const
+{
+	const FString FilePath = FPaths::ProjectSavedDir() / TEXT("Minesweeper")
+		/ FString::Printf(TEXT("MoveLatency_%s.csv"), *FDateTime::Now().ToString());
+
+	if (LatencyStats->ExportCsv(FilePath))
+	{
+		UE_LOG(LogTemp, Display, TEXT("Move latency exported to %s."),
+			*IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*FilePath));
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed to export move latency to %s."), *FilePath);
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -2,21 +2,28 @@
 
 #include "CoreMinimal.h"
 #include "MinesweeperGame.h"
+#include "MinesweeperGameWorker.h"
 #include "UI/MineCellWidget.h"
+#include "Containers/Ticker.h"
 #include "Widgets/Input/SSpinBox.h"
 
 DECLARE_DELEGATE_OneParam(FOnStartNewGame, FMinesweeperGameConfig);
 DECLARE_DELEGATE_OneParam(FOnPlayerInput, FPlayerInput);
+DECLARE_DELEGATE(FOnUndoMove);
+DECLARE_DELEGATE(FOnRedoMove);
+DECLARE_DELEGATE_RetVal(FMinesweeperSnapshotPtr, FOnPollSnapshot);
 
 /**
  * View of minesweeper editor window in MVC pattern. Designed for:
- * 1. Propagates event when starting a new game and upon player input on mine cell.
+ * 1. Propagates event when starting a new game, upon player input on mine cell and upon undo or redo.
  * 2. Render the whole mine grid given game config and game state.
+ * 3. Polling game snapshots every tick when the controller runs on a worker thread.
  */
 class FMinesweeperView
 {
 public:
 	FMinesweeperView();
+	~FMinesweeperView();
 
 	FMinesweeperView(const FMinesweeperView&) = delete;
 	FMinesweeperView& operator=(const FMinesweeperView&) = delete;
@@ -25,17 +32,47 @@ public:
 	void RebuildGameLayout(FMinesweeperGameConfig NewConfig);
 	void UpdateGameLayout(FMinesweeperGameConfig GameConfig, const FMinesweeperGameState& GameState);
 
+	/** Keeps what the player can see up to date from the cells changed since previous notification, ahead of the redraw */
+	void HandleOnCellsChanged(const FMinesweeperGameState& GameState, TConstArrayView<int32> ChangedCells);
+
+	/** Stats to record view time of every move into and to show in the latency overlay, none by default */
+	void SetLatencyStats(class FMinesweeperLatencyStats* InLatencyStats);
+
+	/** Store to show best time and win rate of the current config from, none by default */
+	void SetStatsStore(class FMinesweeperStatsStore* InStatsStore);
+
 public:
 	FOnStartNewGame OnStartNewGame;
 	FOnPlayerInput  OnPlayerInput;
+	FOnUndoMove     OnUndoMove;
+	FOnRedoMove     OnRedoMove;
+	FOnPollSnapshot OnPollSnapshot;
 
 private:
 	TSharedPtr<SWidget> CreateInputWidget();
+	FMinesweeperGameConfig MakeGameConfigFromInput() const;
 	void BroadcastOnStartNewGame();
 	void ValidateMineCountInput();
 	void RebuildMineGridWidget(FMinesweeperGameConfig GameConfig);
 	void UpdateMineGridWidget(FMinesweeperGameConfig GameConfig, const FMinesweeperGameState& GameState);
+	void SetDisplayedLayer(int32 NewLayer);
+	void DrawDisplayedLayer();
 	void UpdateGameStateWidget(EMinesweeperGameState State);
+	void UpdateRemainingMinesWidget(int32 RemainingMineCount);
+	void UpdateStatsWidget();
+	bool IsFlaggedCell(int32 Idx) const;
+	bool IsHiddenCell(int32 Idx) const;
+	int8 GetCellKnowledge(int32 Idx) const;
+
+	bool Tick(float DeltaTime);
+	void PollSnapshot();
+	bool IsProbabilityOverlayEnabled() const;
+	void SubmitProbabilitySnapshot();
+	void ApplyProbabilityOverlay(const struct FMinesweeperProbabilityResult& Result);
+	void ClearProbabilityOverlay();
+	bool IsLatencyOverlayEnabled() const;
+	void UpdateLatencyOverlay();
+	void ExportLatencyStats() const;
 
 private:
 	TArray<FMineCellWidget> MineCellWidgets;
@@ -43,8 +80,54 @@ private:
 	TSharedPtr<class SButton>   NewGameButton;
 	TSharedPtr<SSpinBox<int32>> WidthSpinBox;
 	TSharedPtr<SSpinBox<int32>> HeightSpinBox;
+	TSharedPtr<SSpinBox<int32>> DepthSpinBox;
+	TSharedPtr<SSpinBox<int32>> LayerSpinBox;
 	TSharedPtr<SSpinBox<int32>> MineCountSpinBox;
+	TSharedPtr<class SCheckBox> NoGuessCheckBox;
+	TSharedPtr<class SCheckBox> ProbabilityCheckBox;
+	TSharedPtr<class SCheckBox> LatencyCheckBox;
+
+	TArray<TSharedPtr<ETopology>> TopologyOptions;
+	TSharedPtr<ETopology>         SelectedTopology;
 
 	TSharedPtr<class SUniformGridPanel> MineGridWidget;
 	TSharedPtr<class STextBlock>        GameStateWidget;
+	TSharedPtr<class STextBlock>        RemainingMinesWidget;
+	TSharedPtr<class STextBlock>        StatsWidget;
+	TSharedPtr<class STextBlock>        LatencyWidget;
+
+	/**
+	 * What the player can see of the current board is kept by the probability analyzer. It gets the cells changed
+	 * since the last submission while the overlay is enabled, and the whole board once those went unknown.
+	 */
+	FMinesweeperGameConfig CurrentConfig;
+	EMinesweeperGameState  CurrentState;
+	TArray<int32>          ChangedKnowledgeCells;
+	bool                   bIsCellKnowledgeStale;
+
+	/**
+	 * Whole board as last drawn, so that switching layers of a cube board needs no new game state.
+	 * Views the cells of the model, left alone until next update, or those of the snapshot last drawn,
+	 * which the view holds on to until it draws the next one.
+	 */
+	TConstArrayView<FMineCell> CurrentCells;
+	FMinesweeperSnapshotPtr    DisplayedSnapshot;
+
+	/** Layer of the board shown by the grid widget, and the cell index behind each of its widgets */
+	int32         DisplayedLayer;
+	TArray<int32> WidgetCellIndices;
+
+	TUniquePtr<class FMinesweeperProbabilityAnalyzer> ProbabilityAnalyzer;
+	uint32                                            SubmittedRevision;
+	uint32                                            AppliedRevision;
+	FTSTicker::FDelegateHandle                        TickerHandle;
+
+	class FMinesweeperLatencyStats* LatencyStats;
+
+	/** Revision of the store the stats widget shows, so that it only refreshes once the store changed */
+	class FMinesweeperStatsStore* StatsStore;
+	uint32                        DisplayedStatsRevision;
+
+	/** Game id of the last snapshot drawn, when the controller runs on a worker thread */
+	uint32 DisplayedGameId;
 };
\ No newline at end of file
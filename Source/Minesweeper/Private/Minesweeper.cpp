@@ -4,12 +4,27 @@
 #include "MVC/MinesweeperView.h"
 #include "MVC/MinesweeperModel.h"
 #include "MVC/MinesweeperController.h"
+#include "MVC/MinesweeperGameWorker.h"
+#include "MinesweeperSpectatorServer.h"
+#include "MinesweeperLatencyStats.h"
+#include "MinesweeperStatsStore.h"
 #include "LevelEditor.h"
 #include "Widgets/Docking/SDockTab.h"
 #include "ToolMenus.h"
+#include "HAL/IConsoleManager.h"
 
 static const FName MinesweeperTabName("Minesweeper");
 
+static TAutoConsoleVariable<bool> CVarMinesweeperGameWorker(
+	TEXT("Minesweeper.GameWorker"),
+	false,
+	TEXT("Runs minesweeper game logic on a dedicated worker thread. Takes effect when the tab gets opened."));
+
+static TAutoConsoleVariable<int32> CVarMinesweeperSpectatorPort(
+	TEXT("Minesweeper.SpectatorPort"),
+	0,
+	TEXT("Loopback port streaming the game to spectating tools, zero disables it. Takes effect when the tab gets opened."));
+
 #define LOCTEXT_NAMESPACE "FMinesweeperModule"
 
 void FMinesweeperModule::StartupModule()
@@ -43,19 +58,66 @@ void FMinesweeperModule::ShutdownModule()
 	FMinesweeperStyle::Shutdown();
 	FMinesweeperCommands::Unregister();
 	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(MinesweeperTabName);
+	PluginGameWorker.Reset();
+	PluginSpectatorServer.Reset();
+	PluginStatsStore.Reset();
 }
 
 TSharedRef<SDockTab> FMinesweeperModule::OnSpawnPluginTab(const FSpawnTabArgs& SpawnTabArgs)
 {
+	// Worker references the model and controller, so it has to go first
+	PluginGameWorker.Reset();
+	PluginSpectatorServer.Reset();
+
 	PluginModel = MakeUnique<FMinesweeperModel>();
 	PluginController = MakeUnique<FMinesweeperController>(PluginModel.Get());
 	PluginView = MakeUnique<FMinesweeperView>();
+	PluginLatencyStats = MakeUnique<FMinesweeperLatencyStats>();
+
+	PluginController->SetLatencyStats(PluginLatencyStats.Get());
+	PluginView->SetLatencyStats(PluginLatencyStats.Get());
+
+	// Kept across tabs, its index takes a while to catch up with a log the index on disk is behind of
+	if (!PluginStatsStore)
+	{
+		PluginStatsStore = MakeUnique<FMinesweeperStatsStore>(FPaths::ProjectSavedDir() / TEXT("Minesweeper"));
+	}
+
+	PluginModel->OnGameFinished.BindRaw(PluginStatsStore.Get(), &FMinesweeperStatsStore::HandleOnGameFinished);
+	PluginView->SetStatsStore(PluginStatsStore.Get());
 
-	PluginView->OnPlayerInput.BindRaw(PluginController.Get(), &FMinesweeperController::HandleOnPlayerInput);
-	PluginView->OnStartNewGame.BindRaw(PluginController.Get(), &FMinesweeperController::HandleOnStartNewGame);
+	// Spectators get notified on whichever thread runs the controller, so this goes before the worker starts
+	const int32 SpectatorPort = CVarMinesweeperSpectatorPort.GetValueOnGameThread();
+	if (SpectatorPort > 0)
+	{
+		PluginSpectatorServer = MakeUnique<FMinesweeperSpectatorServer>(SpectatorPort);
+		PluginSpectatorServer->HandleOnGameStarted(PluginModel->GameConfig, PluginModel->GameState);
+
+		PluginModel->OnGameStarted.BindRaw(PluginSpectatorServer.Get(), &FMinesweeperSpectatorServer::HandleOnGameStarted);
+		PluginModel->OnCellsChanged.AddRaw(PluginSpectatorServer.Get(), &FMinesweeperSpectatorServer::HandleOnCellsChanged);
+	}
+
+	if (CVarMinesweeperGameWorker.GetValueOnGameThread())
+	{
+		PluginGameWorker = MakeUnique<FMinesweeperGameWorker>(PluginModel.Get(), PluginController.Get());
 
-	PluginModel->OnGameConfigUpdated.BindRaw(PluginView.Get(), &FMinesweeperView::RebuildGameLayout);
-	PluginModel->OnMineGridChanged.BindRaw(PluginView.Get(), &FMinesweeperView::UpdateGameLayout);
+		PluginView->OnPlayerInput.BindRaw(PluginGameWorker.Get(), &FMinesweeperGameWorker::EnqueuePlayerInput);
+		PluginView->OnStartNewGame.BindRaw(PluginGameWorker.Get(), &FMinesweeperGameWorker::EnqueueStartNewGame);
+		PluginView->OnUndoMove.BindRaw(PluginGameWorker.Get(), &FMinesweeperGameWorker::EnqueueUndoMove);
+		PluginView->OnRedoMove.BindRaw(PluginGameWorker.Get(), &FMinesweeperGameWorker::EnqueueRedoMove);
+		PluginView->OnPollSnapshot.BindRaw(PluginGameWorker.Get(), &FMinesweeperGameWorker::ConsumeSnapshot);
+	}
+	else
+	{
+		PluginView->OnPlayerInput.BindRaw(PluginController.Get(), &FMinesweeperController::HandleOnPlayerInput);
+		PluginView->OnStartNewGame.BindRaw(PluginController.Get(), &FMinesweeperController::HandleOnStartNewGame);
+		PluginView->OnUndoMove.BindRaw(PluginController.Get(), &FMinesweeperController::HandleOnUndoMove);
+		PluginView->OnRedoMove.BindRaw(PluginController.Get(), &FMinesweeperController::HandleOnRedoMove);
+
+		PluginModel->OnGameConfigUpdated.BindRaw(PluginView.Get(), &FMinesweeperView::RebuildGameLayout);
+		PluginModel->OnMineGridChanged.BindRaw(PluginView.Get(), &FMinesweeperView::UpdateGameLayout);
+		PluginModel->OnCellsChanged.AddRaw(PluginView.Get(), &FMinesweeperView::HandleOnCellsChanged);
+	}
 
 	return PluginView->CreateMinesweeperView(SpawnTabArgs, PluginModel->GameConfig);
 }
@@ -0,0 +1,178 @@
+#include "MinesweeperGame.h"
+#include "MinesweeperGrid.h"
+#include "MinesweeperZeroRegions.h"
+#include "Solver/MinesweeperBoardGenerator.h"
+#include "HAL/IConsoleManager.h"
+
+using namespace MinesweeperGrid;
+
+namespace
+{
+	/** Every measurement keeps its fastest run, to filter out page faults of the first one */
+	constexpr int32 BENCHMARK_RUN_COUNT = 3;
+
+	constexpr int32 DEFAULT_BENCHMARK_EDGE = 128;
+	constexpr int32 MAX_BENCHMARK_EDGE = 256;
+	constexpr int32 DEFAULT_BENCHMARK_MINE_PERCENT = 5;
+
+	/** Reveals the zero region around StartIdx and its numbered border breadth first, the way a cascade walks the board */
+	template <typename TTopology>
+	int32 RevealCascade(
+		const TArray<FMineCell>& Cells,
+		const TTopology& Topology,
+		int32 StartIdx,
+		TBitArray<>& Revealed,
+		TArray<int32>& Queue)
+	{
+		Revealed.Init(false, Cells.Num());
+		Queue.Reset();
+
+		Queue.Add(StartIdx);
+		Revealed[StartIdx] = true;
+
+		for (int32 Head = 0; Head < Queue.Num(); ++Head)
+		{
+			const int32 Idx = Queue[Head];
+			if (Cells[Idx].NeighborMineCount > 0)
+			{
+				continue;
+			}
+
+			Topology.ForEachNeighborIndex(Topology.GetCellPosition(Idx), [&](int32 NeighborIdx)
+			{
+				if (!Revealed[NeighborIdx] && !Cells[NeighborIdx].IsMine())
+				{
+					Revealed[NeighborIdx] = true;
+					Queue.Add(NeighborIdx);
+				}
+			});
+		}
+
+		return Queue.Num();
+	}
+
+	template <typename FuncType>
+	double MeasureMilliseconds(FuncType&& Func)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Func();
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	}
+
+	template <typename TTopology>
+	void RunLayoutBenchmark(const FMinesweeperGameConfig& Config, const TTopology& Topology)
+	{
+		TArray<FMineCell> Cells;
+		FMinesweeperZeroRegions ZeroRegions;
+		FMinesweeperGameArena Arena;
+		TBitArray<> Revealed;
+		TArray<int32> Queue;
+		TArray<int32> Parents;
+
+		double GenerateTime = TNumericLimits<double>::Max();
+		double CountTime = TNumericLimits<double>::Max();
+		double LabelTime = TNumericLimits<double>::Max();
+		double MetricsTime = TNumericLimits<double>::Max();
+		FMinesweeperBoardMetrics Metrics{};
+		double RevealTime = TNumericLimits<double>::Max();
+		int32 RevealedCount = 0;
+
+		for (int32 Run = 0; Run < BENCHMARK_RUN_COUNT; ++Run)
+		{
+			Cells.Reset();
+			Cells.AddZeroed(Topology.GetCellCount());
+			Arena.Reset();
+
+			GenerateTime = FMath::Min(GenerateTime, MeasureMilliseconds([&]()
+			{
+				FMinesweeperBoardGenerator::GenerateRandom(Cells, Config, Arena);
+			}));
+
+			CountTime = FMath::Min(CountTime, MeasureMilliseconds([&]()
+			{
+				CalculateNeighborMineCounts(Cells, Topology);
+			}));
+
+			LabelTime = FMath::Min(LabelTime, MeasureMilliseconds([&]()
+			{
+				ZeroRegions.Build(Cells, Topology, Arena);
+			}));
+
+			Parents.SetNumUninitialized(Cells.Num());
+			MetricsTime = FMath::Min(MetricsTime, MeasureMilliseconds([&]()
+			{
+				Metrics = CalculateBoardMetrics(Cells, Topology, Parents);
+			}));
+
+			// Cascade from the largest region, which is what a click on a sparse board runs into
+			int32 LargestRegionId = INDEX_NONE;
+			for (int32 RegionId = 0; RegionId < ZeroRegions.Num(); ++RegionId)
+			{
+				if (LargestRegionId == INDEX_NONE || ZeroRegions.GetRegionCells(RegionId).Num() > ZeroRegions.GetRegionCells(LargestRegionId).Num())
+				{
+					LargestRegionId = RegionId;
+				}
+			}
+
+			if (LargestRegionId == INDEX_NONE)
+			{
+				continue;
+			}
+
+			int32 StartIdx = INDEX_NONE;
+			for (const int32 Idx : ZeroRegions.GetRegionCells(LargestRegionId))
+			{
+				if (ZeroRegions.GetRegionId(Idx) == LargestRegionId)
+				{
+					StartIdx = Idx;
+					break;
+				}
+			}
+
+			RevealTime = FMath::Min(RevealTime, MeasureMilliseconds([&]()
+			{
+				RevealedCount = RevealCascade(Cells, Topology, StartIdx, Revealed, Queue);
+			}));
+		}
+
+		UE_LOG(LogTemp, Display,
+			TEXT("%s layout: generation %.2f ms, of which neighbor counts %.2f ms, zero regions %.2f ms, metrics of 3BV %d %.2f ms, cascade of %d cells %.2f ms."),
+			ResolveCellLayout(Config) == ECellLayout::Morton ? TEXT("Morton") : TEXT("Linear"),
+			GenerateTime, CountTime, LabelTime, Metrics.ThreeBV, MetricsTime, RevealedCount, RevealTime);
+	}
+
+	void RunCubeLayoutBenchmark(const TArray<FString>& Args)
+	{
+		const int32 Edge = FMath::Clamp(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : DEFAULT_BENCHMARK_EDGE, 4, MAX_BENCHMARK_EDGE);
+		const int32 MinePercent = FMath::Clamp(Args.Num() > 1 ? FCString::Atoi(*Args[1]) : DEFAULT_BENCHMARK_MINE_PERCENT, 1, 90);
+
+		FMinesweeperGameConfig Config = FMinesweeperGameConfig::MakeDefaultConfig();
+		Config.GridSize = {Edge, Edge};
+		Config.GridDepth = Edge;
+		Config.Topology = ETopology::Cube;
+		Config.RandomSeed = 0;
+		Config.MineCount = FMath::Max(1, static_cast<int32>(Config.GetCellCount64() * MinePercent / 100));
+
+		UE_LOG(LogTemp, Display, TEXT("Benchmarking %d^3 cube board with %d mines."), Edge, Config.MineCount);
+		if (!FMath::IsPowerOfTwo(Edge))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Edge is not a power of two, Morton layout falls back to linear."));
+		}
+
+		// Both layouts draw mines from the same seed and density, so only their storage order differs
+		for (const ECellLayout Layout : {ECellLayout::Linear, ECellLayout::Morton})
+		{
+			Config.Layout = Layout;
+			DispatchTopology(Config, [&Config](const auto& Topology)
+			{
+				RunLayoutBenchmark(Config, Topology);
+			});
+		}
+	}
+}
+
+static FAutoConsoleCommand CmdMinesweeperBenchmarkCubeLayouts(
+	TEXT("Minesweeper.BenchmarkCubeLayouts"),
+	TEXT("Compares linear and Morton storage of cube boards on generation and large cascades. ")
+	TEXT("Arguments: edge length, a power of two (default 128), and mine density in percent (default 5)."),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunCubeLayoutBenchmark));
@@ -0,0 +1,79 @@
+#include "MinesweeperFrontier.h"
+#include "MinesweeperGrid.h"
+
+void FMinesweeperFrontier::Reset(int32 CellCount, FMinesweeperGameArena& Arena)
+{
+	Cells = Arena.Allocate<int32>(CellCount);
+	CellNum = 0;
+	DenseIndices = Arena.AllocateInit<int32>(CellCount, INDEX_NONE);
+	RevealedNeighborCounts = Arena.AllocateZeroed<uint8>(CellCount);
+}
+
+template <typename TTopology>
+void FMinesweeperFrontier::OnCellRevealed(
+	const TArray<FMineCell>& BoardCells,
+	int32 Idx,
+	const typename TTopology::FPosition& Pos,
+	const TTopology& Topology)
+{
+	Remove(Idx);
+
+	Topology.ForEachNeighborIndex(Pos, [&](int32 NeighborIdx)
+	{
+		if (++RevealedNeighborCounts[NeighborIdx] == 1 && !BoardCells[NeighborIdx].IsUncovered())
+		{
+			Add(NeighborIdx);
+		}
+	});
+}
+
+template <typename TTopology>
+void FMinesweeperFrontier::OnCellConcealed(
+	const TArray<FMineCell>& BoardCells,
+	int32 Idx,
+	const typename TTopology::FPosition& Pos,
+	const TTopology& Topology)
+{
+	if (RevealedNeighborCounts[Idx] > 0)
+	{
+		Add(Idx);
+	}
+
+	Topology.ForEachNeighborIndex(Pos, [&](int32 NeighborIdx)
+	{
+		if (--RevealedNeighborCounts[NeighborIdx] == 0)
+		{
+			Remove(NeighborIdx);
+		}
+	});
+}
+
+#define INSTANTIATE_ON_CELL_CHANGED(TTopology) \
+	template void FMinesweeperFrontier::OnCellRevealed(const TArray<FMineCell>&, int32, const TTopology::FPosition&, const TTopology&); \
+	template void FMinesweeperFrontier::OnCellConcealed(const TArray<FMineCell>&, int32, const TTopology::FPosition&, const TTopology&);
+MINESWEEPER_FOR_EACH_TOPOLOGY(INSTANTIATE_ON_CELL_CHANGED)
+#undef INSTANTIATE_ON_CELL_CHANGED
+
+void FMinesweeperFrontier::Add(int32 Idx)
+{
+	if (DenseIndices[Idx] == INDEX_NONE)
+	{
+		Cells[CellNum] = Idx;
+		DenseIndices[Idx] = CellNum++;
+	}
+}
+
+void FMinesweeperFrontier::Remove(int32 Idx)
+{
+	const int32 DenseIdx = DenseIndices[Idx];
+	if (DenseIdx == INDEX_NONE)
+	{
+		return;
+	}
+
+	const int32 LastIdx = Cells[--CellNum];
+	Cells[DenseIdx] = LastIdx;
+	DenseIndices[LastIdx] = DenseIdx;
+
+	DenseIndices[Idx] = INDEX_NONE;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperGame.h"
+#include "MinesweeperGameArena.h"
+
+/**
+ * Covered cells next to at least one uncovered cell, which is where hints and solvers start from.
+ * An exploded cell counts as uncovered like a revealed one.
+ * Kept up to date cell by cell as cells get uncovered or concealed again by undo, so that
+ * membership tests, insertion and removal are constant time and iteration only touches the frontier.
+ * Flagged cells stay on the frontier, flags being the player's guesses.
+ * Buffers come from the arena of the current game.
+ */
+class FMinesweeperFrontier
+{
+public:
+	/** Empties the frontier of a board with given cell count, none of which is revealed */
+	void Reset(int32 CellCount, FMinesweeperGameArena& Arena);
+
+	/** Cell at given index and position just got revealed or exploded */
+	template <typename TTopology>
+	void OnCellRevealed(const TArray<FMineCell>& Cells, int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology);
+
+	/** Cell at given index and position is no longer revealed or exploded */
+	template <typename TTopology>
+	void OnCellConcealed(const TArray<FMineCell>& Cells, int32 Idx, const typename TTopology::FPosition& Pos, const TTopology& Topology);
+
+	FORCEINLINE bool Contains(int32 Idx) const
+	{
+		return DenseIndices[Idx] != INDEX_NONE;
+	}
+
+	FORCEINLINE int32 Num() const
+	{
+		return CellNum;
+	}
+
+	/** Every frontier cell, in no particular order */
+	FORCEINLINE TConstArrayView<int32> GetCells() const
+	{
+		return TConstArrayView<int32>{Cells.GetData(), CellNum};
+	}
+
+private:
+	void Add(int32 Idx);
+	void Remove(int32 Idx);
+
+private:
+	/** Dense frontier in its first CellNum entries, removal swaps the last cell into the gap */
+	TArrayView<int32> Cells;
+	int32             CellNum = 0;
+
+	/** Position of every cell in the dense frontier, INDEX_NONE if it is not on it */
+	TArrayView<int32> DenseIndices;
+
+	/** Revealed neighbors of every cell, telling whether a concealed cell belongs to the frontier */
+	TArrayView<uint8> RevealedNeighborCounts;
+};
@@ -8,20 +8,53 @@ enum class ECellType
 	Mine,
 };
 
-enum class ECellState
+enum class ECellState : uint8
 {
 	Hidden,
 	Revealed,
 	Exploded,
+	Flagged,
 };
 
-enum class EMinesweeperGameState
+enum class EMinesweeperGameState : uint8
 {
 	Running,
 	GameOver_Win,
 	GameOver_Lose,
 };
 
+enum class EMineGeneration
+{
+	/** Mines are placed uniformly at random when the game starts */
+	Random,
+	/** Mines are placed after the first click so that the board can be solved by logic alone */
+	NoGuess,
+};
+
+enum class ETopology : uint8
+{
+	/** Bounded grid where every cell has up to 8 neighbors */
+	Square,
+	/** Grid that wraps around at its edges, every cell has 8 neighbors */
+	Torus,
+	/** Hexagonal grid with odd rows shifted by half a cell, every cell has up to 6 neighbors */
+	Hexagonal,
+	/** Stack of square layers, every cell has up to 26 neighbors */
+	Cube,
+};
+
+enum class ECellLayout : uint8
+{
+	/** Picks the layout best suited to the board */
+	Auto,
+	/** Row by row, then layer by layer */
+	Linear,
+	/** Square tiles stored contiguously, only for flat boards */
+	Tiled,
+	/** Z-order curve interleaving the bits of every axis, only for cubes whose edge is a power of two */
+	Morton,
+};
+
 enum class EInputType
 {
 	Visit,
@@ -30,8 +63,18 @@ enum class EInputType
 
 struct FPlayerInput
 {
-	FIntPoint  Pos;
+	/** Z is the layer of a cube board and zero on any other board */
+	FIntVector Pos;
 	EInputType Type;
+
+	/** Cycle counter when the player gave the input, for measuring how long the move takes to show */
+	uint64 InputCycles;
+
+	/** Same input regardless of when it was given */
+	FORCEINLINE bool operator==(const FPlayerInput& Other) const
+	{
+		return Pos == Other.Pos && Type == Other.Type;
+	}
 };
 
 struct FMineCell
@@ -40,6 +83,9 @@ struct FMineCell
 	ECellType  CellType;
 	ECellState CellState;
 
+	/** Neighbors currently flagged, kept up to date as flags come and go */
+	uint8      NeighborFlagCount;
+
 	FORCEINLINE bool IsMine() const
 	{
 		return CellType == ECellType::Mine;
@@ -49,6 +95,22 @@ struct FMineCell
 	{
 		return CellState == ECellState::Revealed;
 	}
+
+	/** Revealed, or exploded by a visit that hit its mine, either way no longer covered */
+	FORCEINLINE bool IsUncovered() const
+	{
+		return CellState == ECellState::Revealed || CellState == ECellState::Exploded;
+	}
+
+	FORCEINLINE bool IsHidden() const
+	{
+		return CellState == ECellState::Hidden;
+	}
+
+	FORCEINLINE bool IsFlagged() const
+	{
+		return CellState == ECellState::Flagged;
+	}
 };
 
 struct FMinesweeperGameConfig
@@ -62,27 +124,112 @@ struct FMinesweeperGameConfig
 	static constexpr int32 MIN_MINE_COUNT = 10;
 	static constexpr int32 DEFAULT_MAX_MINE_COUNT = DEFAULT_ROW * DEFAULT_COL - 1;
 	static constexpr int32 DEFAULT_MINE_COUNT = MIN_MINE_COUNT;
+	static constexpr int32 MIN_DEPTH = 3;
+	static constexpr int32 MAX_DEPTH = 16;
+
+	/** Cells around the first click that no-guess generation keeps free of mines, on flat and cube boards */
+	static constexpr int32 NO_GUESS_SAFE_CELL_COUNT = 9;
+	static constexpr int32 NO_GUESS_SAFE_CELL_COUNT_3D = 27;
 
 	FIntPoint        GridSize;
 	int32            MineCount;
 	TOptional<int32> RandomSeed;
+	EMineGeneration  Generation = EMineGeneration::Random;
+	ETopology        Topology = ETopology::Square;
+	/** Number of layers, greater than one only on cube boards */
+	int32            GridDepth = 1;
+	ECellLayout      Layout = ECellLayout::Auto;
+	/**
+	 * Counts neighbor mines of a cell only once it gets revealed, so starting a game only places mines.
+	 * No-guess generation verifies whole boards and always counts every cell.
+	 */
+	bool             bLazyNeighborCounts = false;
+	/**
+	 * Inclusive 3BV range random generation keeps sampling seeds for, so boards come out of a chosen difficulty.
+	 * Such boards always count every cell. Ignored by no-guess generation.
+	 */
+	TOptional<FInt32Interval> TargetThreeBV;
 
 	static FMinesweeperGameConfig MakeDefaultConfig()
 	{
 		return FMinesweeperGameConfig{{DEFAULT_ROW, DEFAULT_COL}, DEFAULT_MINE_COUNT, TOptional<int32>{}};
 	}
 
+	/** Cell count of a board of any size, valid or not, without overflowing */
+	FORCEINLINE int64 GetCellCount64() const
+	{
+		return static_cast<int64>(GridSize.X) * GridSize.Y * GridDepth;
+	}
+
+	/** Cell count of a valid board, cells are addressed by int32 throughout the game logic */
+	FORCEINLINE int32 GetCellCount() const
+	{
+		checkSlow(GetCellCount64() <= MAX_int32);
+		return static_cast<int32>(GetCellCount64());
+	}
+
+	FORCEINLINE int64 GetMaxMineCount64() const
+	{
+		const int32 SafeCellCount = Topology == ETopology::Cube ? NO_GUESS_SAFE_CELL_COUNT_3D : NO_GUESS_SAFE_CELL_COUNT;
+		return Generation == EMineGeneration::NoGuess ? GetCellCount64() - SafeCellCount : GetCellCount64() - 1;
+	}
+
+	FORCEINLINE int32 GetMaxMineCount() const
+	{
+		return static_cast<int32>(FMath::Clamp<int64>(GetMaxMineCount64(), 0, MAX_int32));
+	}
+
 	FORCEINLINE bool IsValid() const
 	{
 		const bool bIsValidCellSize = GridSize.X >= MIN_COL && GridSize.X <= MAX_COL
 				&& GridSize.Y >= MIN_ROW && GridSize.Y <= MAX_ROW;
-		const bool bIsValidMineCount = MineCount < (GridSize.X * GridSize.Y);
-		return bIsValidCellSize && bIsValidMineCount;
+		const bool bIsValidDepth = Topology == ETopology::Cube
+			? GridDepth >= MIN_DEPTH && GridDepth <= MAX_DEPTH
+			: GridDepth == 1;
+		const bool bIsValidMineCount = MineCount <= GetMaxMineCount64();
+		const bool bIsValidTargetThreeBV = !TargetThreeBV || TargetThreeBV->Min <= TargetThreeBV->Max;
+		return bIsValidCellSize && bIsValidDepth && bIsValidMineCount && bIsValidTargetThreeBV;
 	}
 };
 
+/** Standard difficulty measures of a board, which only depend on where its mines are */
+struct FMinesweeperBoardMetrics
+{
+	/** Bechtel's Board Benchmark Value, the fewest clicks clearing the board without flags */
+	int32 ThreeBV;
+
+	/** Connected regions of cells without neighboring mines, each opened along with its border by one click */
+	int32 OpeningCount;
+
+	/** Connected groups of numbered cells bordering no opening, whose cells each take a click of their own */
+	int32 IslandCount;
+};
+
 struct FMinesweeperGameState
 {
 	TArray<FMineCell>     Cells;
 	EMinesweeperGameState State;
-};
\ No newline at end of file
+
+	/** Mine count less the flags placed, which goes negative when the player flags too many cells */
+	int32                 RemainingMineCount;
+
+	/** Unset while mines are yet to be placed, and when neighbor mine counts are computed lazily */
+	TOptional<FMinesweeperBoardMetrics> BoardMetrics;
+};
+
+/** A finished game, as kept by the statistics store */
+struct FMinesweeperGameRecord
+{
+	/** Config of the game, its seed always set */
+	FMinesweeperGameConfig Config;
+	/** Cell a no-guess board got generated around upon first visit, INDEX_NONE for boards placed at game start */
+	int32                  StartIdx;
+	FDateTime              FinishTime;
+	/** From the first move until the game was over */
+	double                 DurationSeconds;
+	EMinesweeperGameState  Outcome;
+	/** INDEX_NONE when the board was not measured, which is the case when counting lazily */
+	int32                  ThreeBV;
+	/** Moves that changed the board, including any undone later */
+	int32                  MoveCount;
+};
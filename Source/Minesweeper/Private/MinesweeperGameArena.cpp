@@ -0,0 +1,59 @@
+#include "MinesweeperGameArena.h"
+
+FMinesweeperGameArena::~FMinesweeperGameArena()
+{
+	for (void* OverflowBlock : OverflowBlocks)
+	{
+		FMemory::Free(OverflowBlock);
+	}
+
+	FMemory::Free(Block);
+}
+
+void FMinesweeperGameArena::Reset()
+{
+	// Steady state, the game fit into the block
+	if (OverflowBlocks.Num() == 0)
+	{
+		UsedSize = 0;
+		return;
+	}
+
+	// Otherwise grow the block to what the game needed, so that the next one of the same size fits
+	const SIZE_T NeededSize = UsedSize + OverflowSize;
+
+	for (void* OverflowBlock : OverflowBlocks)
+	{
+		FMemory::Free(OverflowBlock);
+	}
+	OverflowBlocks.Reset();
+	OverflowSize = 0;
+
+	FMemory::Free(Block);
+	BlockSize = Align(NeededSize, BLOCK_ALIGNMENT);
+	Block = static_cast<uint8*>(FMemory::Malloc(BlockSize, BLOCK_ALIGNMENT));
+	UsedSize = 0;
+}
+
+void* FMinesweeperGameArena::AllocateBytes(SIZE_T Size, SIZE_T Alignment)
+{
+	if (Size == 0)
+	{
+		return nullptr;
+	}
+
+	const SIZE_T Offset = Align(UsedSize, Alignment);
+	if (Block && Offset + Size <= BlockSize)
+	{
+		UsedSize = Offset + Size;
+		return Block + Offset;
+	}
+
+	// Worst case padding is accounted for too, the merged block has to fit the same sequence of buffers
+	const SIZE_T OverflowBlockAlignment = FMath::Max<SIZE_T>(Alignment, BLOCK_ALIGNMENT);
+	OverflowSize += Size + Alignment;
+
+	void* OverflowBlock = FMemory::Malloc(Size, OverflowBlockAlignment);
+	OverflowBlocks.Add(OverflowBlock);
+	return OverflowBlock;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <type_traits>
+
+/**
+ * Linear allocator for buffers that live exactly as long as one game. Designed for:
+ * 1. Handing out per-game buffers by bumping an offset into a single block, without a heap allocation each.
+ * 2. Releasing every buffer at once in constant time when a new game starts.
+ * 3. Keeping its memory across games, so that once a game of some size has been played,
+ *    games of that size or smaller allocate nothing.
+ * A game outgrowing the block is served from extra blocks, merged into one large enough upon next reset.
+ * Buffers are plain views, valid until next reset, and never run destructors.
+ */
+class FMinesweeperGameArena
+{
+public:
+	FMinesweeperGameArena() = default;
+	~FMinesweeperGameArena();
+
+	FMinesweeperGameArena(const FMinesweeperGameArena&) = delete;
+	FMinesweeperGameArena& operator=(const FMinesweeperGameArena&) = delete;
+
+	/** Buffer of given element count with unspecified content */
+	template <typename T>
+	TArrayView<T> Allocate(int32 Count)
+	{
+		static_assert(std::is_trivially_destructible_v<T>, "Arena buffers are released without running destructors");
+		return TArrayView<T>{static_cast<T*>(AllocateBytes(sizeof(T) * Count, alignof(T))), Count};
+	}
+
+	/** Buffer of given element count with every element set to given value */
+	template <typename T>
+	TArrayView<T> AllocateInit(int32 Count, const T& Value)
+	{
+		TArrayView<T> Buffer = Allocate<T>(Count);
+		for (T& Element : Buffer)
+		{
+			Element = Value;
+		}
+		return Buffer;
+	}
+
+	template <typename T>
+	TArrayView<T> AllocateZeroed(int32 Count)
+	{
+		TArrayView<T> Buffer = Allocate<T>(Count);
+		FMemory::Memzero(Buffer.GetData(), sizeof(T) * Count);
+		return Buffer;
+	}
+
+	/** Releases every buffer, keeping memory for the next game */
+	void Reset();
+
+	/** Bytes held for the current game and those to come */
+	SIZE_T GetCapacity() const
+	{
+		return BlockSize + OverflowSize;
+	}
+
+private:
+	void* AllocateBytes(SIZE_T Size, SIZE_T Alignment);
+
+private:
+	static constexpr SIZE_T BLOCK_ALIGNMENT = PLATFORM_CACHE_LINE_SIZE;
+
+	uint8* Block = nullptr;
+	SIZE_T BlockSize = 0;
+	SIZE_T UsedSize = 0;
+
+	/** Blocks allocated once Block ran out during current game */
+	TArray<void*> OverflowBlocks;
+	SIZE_T        OverflowSize = 0;
+};
@@ -0,0 +1,712 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperGame.h"
+
+/**
+ * Topology policies of a mine grid. Every policy owns both neighborhood and storage order of cells and supplies:
+ * 1. FPosition, the coordinate type of a cell, and MAX_NEIGHBOR_COUNT, the size of a cell's neighborhood.
+ *    MakePosition and MakeInputPosition convert it from and to an input position, Z being the layer.
+ * 2. GetCellCount, GetCellIndex and GetCellPosition, mapping between positions and storage indices.
+ * 3. IsValidCellPosition, whether a position is on the board.
+ * 4. ForEachNeighbor, invoking a functor with index and position of every neighbor of a position,
+ *    and ForEachNeighborIndex, the same with the index only.
+ * 5. ForEachCell, invoking a functor with index and position of every cell in ascending index order.
+ * Board logic is templated on the policy, so neighborhood handling is resolved at compile time.
+ * Hot loops carry positions along with indices, since GetCellPosition costs a division per call.
+ * A custom neighborhood only needs a new policy, a case in MinesweeperGrid::DispatchTopology
+ * and an entry in MINESWEEPER_FOR_EACH_TOPOLOGY.
+ */
+
+/** Row-major storage of a flat grid */
+struct FLinearCellLayout2D
+{
+	static FORCEINLINE int32 GetCellIndex(const FIntPoint& GridSize, FIntPoint Pos)
+	{
+		return Pos.Y * GridSize.X + Pos.X;
+	}
+
+	static FORCEINLINE FIntPoint GetCellPosition(const FIntPoint& GridSize, int32 Idx)
+	{
+		return FIntPoint{Idx % GridSize.X, Idx / GridSize.X};
+	}
+
+	template <typename FuncType>
+	static FORCEINLINE void ForEachCell(const FIntPoint& GridSize, FuncType&& Func)
+	{
+		int32 Idx = 0;
+		for (int32 Y = 0; Y < GridSize.Y; ++Y)
+		{
+			for (int32 X = 0; X < GridSize.X; ++X)
+			{
+				Func(Idx++, FIntPoint{X, Y});
+			}
+		}
+	}
+};
+
+/**
+ * Square tiles stored one after another, row-major within a tile and tiles row by row.
+ * Tiles on the right and bottom edge are cropped to the board, so no storage is wasted,
+ * and every row of tiles starts at a multiple of TILE_SIZE rows.
+ */
+struct FTiledCellLayout2D
+{
+	static constexpr int32 TILE_SHIFT = 3;
+	static constexpr int32 TILE_SIZE = 1 << TILE_SHIFT;
+	static constexpr int32 TILE_MASK = TILE_SIZE - 1;
+
+	/** Rows this wide span several cache lines, so that vertical neighbors of row-major cells miss the cache */
+	static constexpr int32 AUTO_MIN_GRID_WIDTH = 64;
+
+	static FORCEINLINE int32 GetCellIndex(const FIntPoint& GridSize, FIntPoint Pos)
+	{
+		const int32 TileX = Pos.X >> TILE_SHIFT;
+		const int32 TileY = Pos.Y >> TILE_SHIFT;
+		const int32 TileWidth = FMath::Min(TILE_SIZE, GridSize.X - (TileX << TILE_SHIFT));
+		const int32 TileHeight = FMath::Min(TILE_SIZE, GridSize.Y - (TileY << TILE_SHIFT));
+
+		return (TileY << TILE_SHIFT) * GridSize.X
+			+ (TileX << TILE_SHIFT) * TileHeight
+			+ (Pos.Y & TILE_MASK) * TileWidth
+			+ (Pos.X & TILE_MASK);
+	}
+
+	static FORCEINLINE FIntPoint GetCellPosition(const FIntPoint& GridSize, int32 Idx)
+	{
+		const int32 TileRowSize = GridSize.X << TILE_SHIFT;
+		const int32 TileY = Idx / TileRowSize;
+		const int32 TileHeight = FMath::Min(TILE_SIZE, GridSize.Y - (TileY << TILE_SHIFT));
+		const int32 TileRowIdx = Idx - TileY * TileRowSize;
+
+		const int32 TileX = TileRowIdx / (TileHeight << TILE_SHIFT);
+		const int32 TileWidth = FMath::Min(TILE_SIZE, GridSize.X - (TileX << TILE_SHIFT));
+		const int32 TileIdx = TileRowIdx - TileX * (TileHeight << TILE_SHIFT);
+
+		return FIntPoint{(TileX << TILE_SHIFT) + TileIdx % TileWidth, (TileY << TILE_SHIFT) + TileIdx / TileWidth};
+	}
+
+	template <typename FuncType>
+	static FORCEINLINE void ForEachCell(const FIntPoint& GridSize, FuncType&& Func)
+	{
+		int32 Idx = 0;
+		for (int32 TileY = 0; TileY < GridSize.Y; TileY += TILE_SIZE)
+		{
+			const int32 EndY = FMath::Min(TileY + TILE_SIZE, GridSize.Y);
+			for (int32 TileX = 0; TileX < GridSize.X; TileX += TILE_SIZE)
+			{
+				const int32 EndX = FMath::Min(TileX + TILE_SIZE, GridSize.X);
+				for (int32 Y = TileY; Y < EndY; ++Y)
+				{
+					for (int32 X = TileX; X < EndX; ++X)
+					{
+						Func(Idx++, FIntPoint{X, Y});
+					}
+				}
+			}
+		}
+	}
+};
+
+/** Flat grid storing cells of a GridSize rectangle in given layout, shared by every 2D policy */
+template <typename TCellLayout>
+struct TPlanarTopology
+{
+	using FPosition = FIntPoint;
+
+	FIntPoint GridSize;
+
+	static FORCEINLINE FIntPoint MakePosition(FIntVector Pos)
+	{
+		return FIntPoint{Pos.X, Pos.Y};
+	}
+
+	static FORCEINLINE FIntVector MakeInputPosition(FIntPoint Pos)
+	{
+		return FIntVector{Pos.X, Pos.Y, 0};
+	}
+
+	FORCEINLINE int32 GetCellCount() const
+	{
+		return GridSize.X * GridSize.Y;
+	}
+
+	FORCEINLINE bool IsValidCellPosition(FIntPoint Pos) const
+	{
+		return Pos.X >= 0 && Pos.X < GridSize.X
+			&& Pos.Y >= 0 && Pos.Y < GridSize.Y;
+	}
+
+	FORCEINLINE int32 GetCellIndex(FIntPoint Pos) const
+	{
+		return TCellLayout::GetCellIndex(GridSize, Pos);
+	}
+
+	FORCEINLINE FIntPoint GetCellPosition(int32 Idx) const
+	{
+		return TCellLayout::GetCellPosition(GridSize, Idx);
+	}
+
+	template <typename FuncType>
+	FORCEINLINE void ForEachCell(FuncType&& Func) const
+	{
+		TCellLayout::ForEachCell(GridSize, Forward<FuncType>(Func));
+	}
+};
+
+/** Classic bounded grid, every cell has up to 8 neighbors */
+template <typename TCellLayout>
+struct TSquareTopology : TPlanarTopology<TCellLayout>
+{
+	static constexpr int32 MAX_NEIGHBOR_COUNT = 8;
+
+	template <typename FuncType>
+	FORCEINLINE void ForEachNeighbor(FIntPoint Pos, FuncType&& Func) const
+	{
+		static const FIntPoint NEIGHBOR_OFFSETS[] =
+		{
+			{-1, -1}, { 0, -1}, { 1, -1},
+			{-1,  0},           { 1,  0},
+			{-1,  1}, { 0,  1}, { 1,  1},
+		};
+
+		for (const FIntPoint Offset : NEIGHBOR_OFFSETS)
+		{
+			const FIntPoint Neighbor = Pos + Offset;
+			if (this->IsValidCellPosition(Neighbor))
+			{
+				Func(this->GetCellIndex(Neighbor), Neighbor);
+			}
+		}
+	}
+
+	template <typename FuncType>
+	FORCEINLINE void ForEachNeighborIndex(FIntPoint Pos, FuncType&& Func) const
+	{
+		ForEachNeighbor(Pos, [&Func](int32 NeighborIdx, FIntPoint)
+		{
+			Func(NeighborIdx);
+		});
+	}
+};
+
+/** Grid whose opposite edges are connected, every cell has exactly 8 neighbors */
+template <typename TCellLayout>
+struct TTorusTopology : TPlanarTopology<TCellLayout>
+{
+	static constexpr int32 MAX_NEIGHBOR_COUNT = 8;
+
+	template <typename FuncType>
+	FORCEINLINE void ForEachNeighbor(FIntPoint Pos, FuncType&& Func) const
+	{
+		const FIntPoint GridSize = this->GridSize;
+
+		// Grid is at least 3 cells wide and high, so wrapped neighbors never repeat
+		const int32 Rows[] = {Pos.Y == 0 ? GridSize.Y - 1 : Pos.Y - 1, Pos.Y, Pos.Y == GridSize.Y - 1 ? 0 : Pos.Y + 1};
+		const int32 Cols[] = {Pos.X == 0 ? GridSize.X - 1 : Pos.X - 1, Pos.X, Pos.X == GridSize.X - 1 ? 0 : Pos.X + 1};
+
+		for (int32 Row = 0; Row < 3; ++Row)
+		{
+			for (int32 Col = 0; Col < 3; ++Col)
+			{
+				if (Row != 1 || Col != 1)
+				{
+					const FIntPoint Neighbor{Cols[Col], Rows[Row]};
+					Func(this->GetCellIndex(Neighbor), Neighbor);
+				}
+			}
+		}
+	}
+
+	template <typename FuncType>
+	FORCEINLINE void ForEachNeighborIndex(FIntPoint Pos, FuncType&& Func) const
+	{
+		ForEachNeighbor(Pos, [&Func](int32 NeighborIdx, FIntPoint)
+		{
+			Func(NeighborIdx);
+		});
+	}
+};
+
+/** Hexagonal grid in odd-row offset layout, every odd row is shifted right by half a cell */
+template <typename TCellLayout>
+struct THexTopology : TPlanarTopology<TCellLayout>
+{
+	static constexpr int32 MAX_NEIGHBOR_COUNT = 6;
+
+	template <typename FuncType>
+	FORCEINLINE void ForEachNeighbor(FIntPoint Pos, FuncType&& Func) const
+	{
+		static const FIntPoint EVEN_ROW_OFFSETS[] =
+		{
+			{-1, -1}, { 0, -1},
+			{-1,  0}, { 1,  0},
+			{-1,  1}, { 0,  1},
+		};
+		static const FIntPoint ODD_ROW_OFFSETS[] =
+		{
+			{ 0, -1}, { 1, -1},
+			{-1,  0}, { 1,  0},
+			{ 0,  1}, { 1,  1},
+		};
+
+		const FIntPoint* Offsets = (Pos.Y & 1) ? ODD_ROW_OFFSETS : EVEN_ROW_OFFSETS;
+		for (int32 OffsetIdx = 0; OffsetIdx < MAX_NEIGHBOR_COUNT; ++OffsetIdx)
+		{
+			const FIntPoint Neighbor = Pos + Offsets[OffsetIdx];
+			if (this->IsValidCellPosition(Neighbor))
+			{
+				Func(this->GetCellIndex(Neighbor), Neighbor);
+			}
+		}
+	}
+
+	template <typename FuncType>
+	FORCEINLINE void ForEachNeighborIndex(FIntPoint Pos, FuncType&& Func) const
+	{
+		ForEachNeighbor(Pos, [&Func](int32 NeighborIdx, FIntPoint)
+		{
+			Func(NeighborIdx);
+		});
+	}
+};
+
+using FSquareTopology = TSquareTopology<FLinearCellLayout2D>;
+using FTorusTopology = TTorusTopology<FLinearCellLayout2D>;
+using FHexTopology = THexTopology<FLinearCellLayout2D>;
+using FTiledSquareTopology = TSquareTopology<FTiledCellLayout2D>;
+using FTiledTorusTopology = TTorusTopology<FTiledCellLayout2D>;
+using FTiledHexTopology = THexTopology<FTiledCellLayout2D>;
+
+/**
+ * Storage orders of a cube board. A cell index is the sum of independent per-axis offsets,
+ * so neighbor lookups only encode each of the three neighboring coordinates once per axis.
+ */
+struct FLinearCellLayout3D
+{
+	static FORCEINLINE int32 EncodeX(const FIntVector& GridSize, int32 X)
+	{
+		return X;
+	}
+
+	static FORCEINLINE int32 EncodeY(const FIntVector& GridSize, int32 Y)
+	{
+		return Y * GridSize.X;
+	}
+
+	static FORCEINLINE int32 EncodeZ(const FIntVector& GridSize, int32 Z)
+	{
+		return Z * GridSize.X * GridSize.Y;
+	}
+
+	static FORCEINLINE FIntVector Decode(const FIntVector& GridSize, int32 Idx)
+	{
+		const int32 LayerSize = GridSize.X * GridSize.Y;
+		const int32 LayerIdx = Idx % LayerSize;
+		return FIntVector{LayerIdx % GridSize.X, LayerIdx / GridSize.X, Idx / LayerSize};
+	}
+
+	template <typename FuncType>
+	static FORCEINLINE void ForEachCell(const FIntVector& GridSize, FuncType&& Func)
+	{
+		int32 Idx = 0;
+		for (int32 Z = 0; Z < GridSize.Z; ++Z)
+		{
+			for (int32 Y = 0; Y < GridSize.Y; ++Y)
+			{
+				for (int32 X = 0; X < GridSize.X; ++X)
+				{
+					Func(Idx++, FIntVector{X, Y, Z});
+				}
+			}
+		}
+	}
+};
+
+/** Z-order curve, keeps all 26 neighbors of most cells within a few cache lines */
+struct FMortonCellLayout3D
+{
+	/** Edges up to 1024 cells keep every index within 30 bits */
+	static constexpr int32 MAX_EDGE = 1024;
+
+	static FORCEINLINE bool SupportsGridSize(const FIntVector& GridSize)
+	{
+		return GridSize.X == GridSize.Y && GridSize.X == GridSize.Z
+			&& FMath::IsPowerOfTwo(GridSize.X) && GridSize.X <= MAX_EDGE;
+	}
+
+	/** Spreads the lower 10 bits of Value two bits apart */
+	static FORCEINLINE uint32 SpreadBits(uint32 Value)
+	{
+		Value &= 0x000003ff;
+		Value = (Value ^ (Value << 16)) & 0xff0000ff;
+		Value = (Value ^ (Value << 8)) & 0x0300f00f;
+		Value = (Value ^ (Value << 4)) & 0x030c30c3;
+		Value = (Value ^ (Value << 2)) & 0x09249249;
+		return Value;
+	}
+
+	/** Inverse of SpreadBits, gathers every third bit of Value */
+	static FORCEINLINE uint32 CompactBits(uint32 Value)
+	{
+		Value &= 0x09249249;
+		Value = (Value ^ (Value >> 2)) & 0x030c30c3;
+		Value = (Value ^ (Value >> 4)) & 0x0300f00f;
+		Value = (Value ^ (Value >> 8)) & 0xff0000ff;
+		Value = (Value ^ (Value >> 16)) & 0x000003ff;
+		return Value;
+	}
+
+	static FORCEINLINE int32 EncodeX(const FIntVector& GridSize, int32 X)
+	{
+		return static_cast<int32>(SpreadBits(X));
+	}
+
+	static FORCEINLINE int32 EncodeY(const FIntVector& GridSize, int32 Y)
+	{
+		return static_cast<int32>(SpreadBits(Y) << 1);
+	}
+
+	static FORCEINLINE int32 EncodeZ(const FIntVector& GridSize, int32 Z)
+	{
+		return static_cast<int32>(SpreadBits(Z) << 2);
+	}
+
+	static FORCEINLINE FIntVector Decode(const FIntVector& GridSize, int32 Idx)
+	{
+		const uint32 Code = static_cast<uint32>(Idx);
+		return FIntVector{
+			static_cast<int32>(CompactBits(Code)),
+			static_cast<int32>(CompactBits(Code >> 1)),
+			static_cast<int32>(CompactBits(Code >> 2))};
+	}
+
+	template <typename FuncType>
+	static FORCEINLINE void ForEachCell(const FIntVector& GridSize, FuncType&& Func)
+	{
+		const int32 CellCount = GridSize.X * GridSize.Y * GridSize.Z;
+		for (int32 Idx = 0; Idx < CellCount; ++Idx)
+		{
+			Func(Idx, Decode(GridSize, Idx));
+		}
+	}
+};
+
+/** Bounded stack of square layers, every cell has up to 26 neighbors */
+template <typename TCellLayout>
+struct TCubeTopology
+{
+	using FPosition = FIntVector;
+
+	static constexpr int32 MAX_NEIGHBOR_COUNT = 26;
+
+	FIntVector GridSize;
+
+	static FORCEINLINE FIntVector MakePosition(FIntVector Pos)
+	{
+		return Pos;
+	}
+
+	static FORCEINLINE FIntVector MakeInputPosition(FIntVector Pos)
+	{
+		return Pos;
+	}
+
+	FORCEINLINE int32 GetCellCount() const
+	{
+		return GridSize.X * GridSize.Y * GridSize.Z;
+	}
+
+	FORCEINLINE bool IsValidCellPosition(FIntVector Pos) const
+	{
+		return Pos.X >= 0 && Pos.X < GridSize.X
+			&& Pos.Y >= 0 && Pos.Y < GridSize.Y
+			&& Pos.Z >= 0 && Pos.Z < GridSize.Z;
+	}
+
+	FORCEINLINE int32 GetCellIndex(FIntVector Pos) const
+	{
+		return TCellLayout::EncodeX(GridSize, Pos.X) + TCellLayout::EncodeY(GridSize, Pos.Y) + TCellLayout::EncodeZ(GridSize, Pos.Z);
+	}
+
+	FORCEINLINE FIntVector GetCellPosition(int32 Idx) const
+	{
+		return TCellLayout::Decode(GridSize, Idx);
+	}
+
+	template <typename FuncType>
+	FORCEINLINE void ForEachNeighbor(FIntVector Pos, FuncType&& Func) const
+	{
+		// Offsets of the previous, current and next coordinate along every axis, INDEX_NONE when off the board
+		int32 OffsetsX[3];
+		int32 OffsetsY[3];
+		int32 OffsetsZ[3];
+		for (int32 Step = 0; Step < 3; ++Step)
+		{
+			const int32 X = Pos.X + Step - 1;
+			const int32 Y = Pos.Y + Step - 1;
+			const int32 Z = Pos.Z + Step - 1;
+			OffsetsX[Step] = X >= 0 && X < GridSize.X ? TCellLayout::EncodeX(GridSize, X) : INDEX_NONE;
+			OffsetsY[Step] = Y >= 0 && Y < GridSize.Y ? TCellLayout::EncodeY(GridSize, Y) : INDEX_NONE;
+			OffsetsZ[Step] = Z >= 0 && Z < GridSize.Z ? TCellLayout::EncodeZ(GridSize, Z) : INDEX_NONE;
+		}
+
+		for (int32 StepZ = 0; StepZ < 3; ++StepZ)
+		{
+			if (OffsetsZ[StepZ] == INDEX_NONE)
+			{
+				continue;
+			}
+
+			for (int32 StepY = 0; StepY < 3; ++StepY)
+			{
+				if (OffsetsY[StepY] == INDEX_NONE)
+				{
+					continue;
+				}
+
+				for (int32 StepX = 0; StepX < 3; ++StepX)
+				{
+					const bool bIsSelf = StepX == 1 && StepY == 1 && StepZ == 1;
+					if (OffsetsX[StepX] != INDEX_NONE && !bIsSelf)
+					{
+						const FIntVector Neighbor{Pos.X + StepX - 1, Pos.Y + StepY - 1, Pos.Z + StepZ - 1};
+						Func(OffsetsX[StepX] + OffsetsY[StepY] + OffsetsZ[StepZ], Neighbor);
+					}
+				}
+			}
+		}
+	}
+
+	template <typename FuncType>
+	FORCEINLINE void ForEachNeighborIndex(FIntVector Pos, FuncType&& Func) const
+	{
+		ForEachNeighbor(Pos, [&Func](int32 NeighborIdx, FIntVector)
+		{
+			Func(NeighborIdx);
+		});
+	}
+
+	template <typename FuncType>
+	FORCEINLINE void ForEachCell(FuncType&& Func) const
+	{
+		TCellLayout::ForEachCell(GridSize, Forward<FuncType>(Func));
+	}
+};
+
+using FLinearCubeTopology = TCubeTopology<FLinearCellLayout3D>;
+using FMortonCubeTopology = TCubeTopology<FMortonCellLayout3D>;
+
+/** Invokes Op with every topology policy, for explicit instantiation of board logic */
+#define MINESWEEPER_FOR_EACH_TOPOLOGY(Op) \
+	Op(FSquareTopology) \
+	Op(FTorusTopology) \
+	Op(FHexTopology) \
+	Op(FTiledSquareTopology) \
+	Op(FTiledTorusTopology) \
+	Op(FTiledHexTopology) \
+	Op(FLinearCubeTopology) \
+	Op(FMortonCubeTopology)
+
+/**
+ * Helpers for addressing cells of a mine grid.
+ * Shared by the controller and the solver so they agree on neighborhood and indexing.
+ */
+namespace MinesweeperGrid
+{
+	/** Storage order a board of given config ends up with, never Auto */
+	FORCEINLINE ECellLayout ResolveCellLayout(const FMinesweeperGameConfig& Config)
+	{
+		if (Config.Topology == ETopology::Cube)
+		{
+			const FIntVector GridSize{Config.GridSize.X, Config.GridSize.Y, Config.GridDepth};
+			const bool bCanUseMorton = FMortonCellLayout3D::SupportsGridSize(GridSize);
+			const bool bWantsMorton = Config.Layout == ECellLayout::Auto || Config.Layout == ECellLayout::Morton;
+			return bCanUseMorton && bWantsMorton ? ECellLayout::Morton : ECellLayout::Linear;
+		}
+
+		const bool bWantsTiled = Config.Layout == ECellLayout::Tiled
+			|| (Config.Layout == ECellLayout::Auto && Config.GridSize.X >= FTiledCellLayout2D::AUTO_MIN_GRID_WIDTH);
+		return bWantsTiled ? ECellLayout::Tiled : ECellLayout::Linear;
+	}
+
+	/** Invokes Func with the topology policy of the config. The only runtime branch on topology and layout */
+	template <typename FuncType>
+	FORCEINLINE decltype(auto) DispatchTopology(const FMinesweeperGameConfig& Config, FuncType&& Func)
+	{
+		const ECellLayout Layout = ResolveCellLayout(Config);
+
+		switch (Config.Topology)
+		{
+		case ETopology::Torus:
+			if (Layout == ECellLayout::Tiled)
+			{
+				return Func(FTiledTorusTopology{{Config.GridSize}});
+			}
+			return Func(FTorusTopology{{Config.GridSize}});
+		case ETopology::Hexagonal:
+			if (Layout == ECellLayout::Tiled)
+			{
+				return Func(FTiledHexTopology{{Config.GridSize}});
+			}
+			return Func(FHexTopology{{Config.GridSize}});
+		case ETopology::Cube:
+			{
+				const FIntVector GridSize{Config.GridSize.X, Config.GridSize.Y, Config.GridDepth};
+				if (Layout == ECellLayout::Morton)
+				{
+					return Func(FMortonCubeTopology{GridSize});
+				}
+				return Func(FLinearCubeTopology{GridSize});
+			}
+		case ETopology::Square:
+		default:
+			if (Layout == ECellLayout::Tiled)
+			{
+				return Func(FTiledSquareTopology{{Config.GridSize}});
+			}
+			return Func(FSquareTopology{{Config.GridSize}});
+		}
+	}
+
+	/** Whether an input position is on the board, Z being the layer */
+	FORCEINLINE bool IsValidCellPosition(const FMinesweeperGameConfig& Config, FIntVector Pos)
+	{
+		return Pos.X >= 0 && Pos.X < Config.GridSize.X
+			&& Pos.Y >= 0 && Pos.Y < Config.GridSize.Y
+			&& Pos.Z >= 0 && Pos.Z < Config.GridDepth;
+	}
+
+	/** Storage index of an input position, Z being the layer */
+	FORCEINLINE int32 GetCellIndex(const FMinesweeperGameConfig& Config, FIntVector Pos)
+	{
+		check(IsValidCellPosition(Config, Pos));
+		return DispatchTopology(Config, [Pos](const auto& Topology)
+		{
+			return Topology.GetCellIndex(Topology.MakePosition(Pos));
+		});
+	}
+
+	/** Recalculates neighbor mine count of every cell */
+	template <typename TTopology>
+	void CalculateNeighborMineCounts(TArrayView<FMineCell> Cells, const TTopology& Topology)
+	{
+		Topology.ForEachCell([&](int32 Idx, const typename TTopology::FPosition& Pos)
+		{
+			int32 NeighborMineCount = 0;
+			Topology.ForEachNeighborIndex(Pos, [&](int32 NeighborIdx)
+			{
+				NeighborMineCount += Cells[NeighborIdx].IsMine();
+			});
+			Cells[Idx].NeighborMineCount = NeighborMineCount;
+		});
+	}
+
+	/** Root of a cell in a union-find forest, halving the path on the way */
+	FORCEINLINE int32 FindRoot(TArrayView<int32> Parents, int32 Idx)
+	{
+		while (Parents[Idx] != Idx)
+		{
+			Parents[Idx] = Parents[Parents[Idx]];
+			Idx = Parents[Idx];
+		}
+		return Idx;
+	}
+
+	/**
+	 * Measures difficulty of a board whose neighbor mine counts are final, in a single pass without flood filling.
+	 * Openings and islands are labeled with union-find over Parents, scratch of one element per cell.
+	 * Relies on ForEachCell visiting cells in ascending index order, so every earlier neighbor is already labeled.
+	 */
+	template <typename TTopology>
+	FMinesweeperBoardMetrics CalculateBoardMetrics(
+		const TArray<FMineCell>& Cells,
+		const TTopology& Topology,
+		TArrayView<int32> Parents)
+	{
+		check(Parents.Num() == Cells.Num());
+
+		int32 ZeroCellCount = 0;
+		int32 IslandCellCount = 0;
+
+		// Every union of two components takes one away from the count of the kind they belong to
+		int32 OpeningMergeCount = 0;
+		int32 IslandMergeCount = 0;
+
+		auto Union = [&Parents](int32 Idx, int32 OtherIdx)
+		{
+			const int32 Root = FindRoot(Parents, Idx);
+			const int32 OtherRoot = FindRoot(Parents, OtherIdx);
+			if (Root == OtherRoot)
+			{
+				return false;
+			}
+
+			Parents[Root] = OtherRoot;
+			return true;
+		};
+
+		Topology.ForEachCell([&](int32 Idx, const typename TTopology::FPosition& Pos)
+		{
+			const FMineCell& Cell = Cells[Idx];
+
+			// Mines and numbered cells bordering an opening belong to no component
+			Parents[Idx] = INDEX_NONE;
+			if (Cell.IsMine())
+			{
+				return;
+			}
+
+			if (Cell.NeighborMineCount == 0)
+			{
+				Parents[Idx] = Idx;
+				++ZeroCellCount;
+
+				Topology.ForEachNeighborIndex(Pos, [&](int32 NeighborIdx)
+				{
+					const FMineCell& Neighbor = Cells[NeighborIdx];
+					if (NeighborIdx < Idx && !Neighbor.IsMine() && Neighbor.NeighborMineCount == 0)
+					{
+						OpeningMergeCount += Union(Idx, NeighborIdx);
+					}
+				});
+				return;
+			}
+
+			bool bBordersOpening = false;
+			Topology.ForEachNeighborIndex(Pos, [&](int32 NeighborIdx)
+			{
+				bBordersOpening |= !Cells[NeighborIdx].IsMine() && Cells[NeighborIdx].NeighborMineCount == 0;
+			});
+
+			if (bBordersOpening)
+			{
+				return;
+			}
+
+			Parents[Idx] = Idx;
+			++IslandCellCount;
+
+			Topology.ForEachNeighborIndex(Pos, [&](int32 NeighborIdx)
+			{
+				// Later neighbors are yet to be labeled, their parent is still whatever the scratch held
+				if (NeighborIdx > Idx)
+				{
+					return;
+				}
+
+				const bool bIsIslandCell = Parents[NeighborIdx] != INDEX_NONE && Cells[NeighborIdx].NeighborMineCount > 0;
+				if (bIsIslandCell)
+				{
+					IslandMergeCount += Union(Idx, NeighborIdx);
+				}
+			});
+		});
+
+		FMinesweeperBoardMetrics Metrics;
+		Metrics.OpeningCount = ZeroCellCount - OpeningMergeCount;
+		Metrics.IslandCount = IslandCellCount - IslandMergeCount;
+		Metrics.ThreeBV = Metrics.OpeningCount + IslandCellCount;
+		return Metrics;
+	}
+}
@@ -0,0 +1,140 @@
+#include "MinesweeperJournal.h"
+#include "Algo/StableSort.h"
+
+FMinesweeperJournal::FMinesweeperJournal() :
+	EntryCount{0},
+	PendingPreviousState{EMinesweeperGameState::Running}
+{
+}
+
+void FMinesweeperJournal::BeginMove(EMinesweeperGameState State)
+{
+	PendingChanges.Reset();
+	PendingPreviousState = State;
+}
+
+void FMinesweeperJournal::RecordCellChange(int32 Idx, ECellState PreviousState, ECellState NewState)
+{
+	if (PreviousState != NewState)
+	{
+		PendingChanges.Add({Idx, PreviousState, NewState});
+	}
+}
+
+bool FMinesweeperJournal::EndMove(EMinesweeperGameState State)
+{
+	if (PendingChanges.Num() == 0 && PendingPreviousState == State)
+	{
+		return false;
+	}
+
+	// A new move invalidates whatever could have been redone
+	if (EntryCount < Entries.Num())
+	{
+		Runs.SetNum(EntryCount > 0 ? Entries[EntryCount - 1].FirstRun + Entries[EntryCount - 1].RunCount : 0, false);
+		Entries.SetNum(EntryCount, false);
+	}
+
+	// Stable so that a cell changed twice keeps its changes in order
+	Algo::StableSortBy(PendingChanges, &FCellChange::Idx);
+
+	FJournalEntry& Entry = Entries.Emplace_GetRef();
+	Entry.FirstRun = Runs.Num();
+	Entry.PreviousState = PendingPreviousState;
+	Entry.NewState = State;
+
+	for (int32 ChangeIdx = 0; ChangeIdx < PendingChanges.Num(); ++ChangeIdx)
+	{
+		FCellChange Change = PendingChanges[ChangeIdx];
+
+		// Collapse repeated changes of the same cell into one
+		while (ChangeIdx + 1 < PendingChanges.Num() && PendingChanges[ChangeIdx + 1].Idx == Change.Idx)
+		{
+			Change.NewState = PendingChanges[++ChangeIdx].NewState;
+		}
+
+		if (Change.PreviousState == Change.NewState)
+		{
+			continue;
+		}
+
+		FCellStateRun* LastRun = Runs.Num() > Entry.FirstRun ? &Runs.Last() : nullptr;
+		const bool bExtendsLastRun = LastRun
+			&& LastRun->StartIdx + LastRun->Length == Change.Idx
+			&& LastRun->PreviousState == Change.PreviousState
+			&& LastRun->NewState == Change.NewState
+			&& LastRun->Length < MAX_uint16;
+
+		if (bExtendsLastRun)
+		{
+			++LastRun->Length;
+		}
+		else
+		{
+			Runs.Add({Change.Idx, 1, Change.PreviousState, Change.NewState});
+		}
+	}
+
+	Entry.RunCount = Runs.Num() - Entry.FirstRun;
+	EntryCount = Entries.Num();
+	PendingChanges.Reset();
+
+	return true;
+}
+
+bool FMinesweeperJournal::Undo(FMinesweeperGameState& GameState, FOnCellChanged OnCellChanged)
+{
+	if (!CanUndo())
+	{
+		return false;
+	}
+
+	const FJournalEntry& Entry = Entries[--EntryCount];
+	for (int32 RunIdx = Entry.FirstRun; RunIdx < Entry.FirstRun + Entry.RunCount; ++RunIdx)
+	{
+		const FCellStateRun& Run = Runs[RunIdx];
+		for (int32 Idx = Run.StartIdx; Idx < Run.StartIdx + Run.Length; ++Idx)
+		{
+			GameState.Cells[Idx].CellState = Run.PreviousState;
+			OnCellChanged(Idx, Run.NewState, Run.PreviousState);
+		}
+	}
+	GameState.State = Entry.PreviousState;
+
+	return true;
+}
+
+bool FMinesweeperJournal::Redo(FMinesweeperGameState& GameState, FOnCellChanged OnCellChanged)
+{
+	if (!CanRedo())
+	{
+		return false;
+	}
+
+	const FJournalEntry& Entry = Entries[EntryCount++];
+	for (int32 RunIdx = Entry.FirstRun; RunIdx < Entry.FirstRun + Entry.RunCount; ++RunIdx)
+	{
+		const FCellStateRun& Run = Runs[RunIdx];
+		for (int32 Idx = Run.StartIdx; Idx < Run.StartIdx + Run.Length; ++Idx)
+		{
+			GameState.Cells[Idx].CellState = Run.NewState;
+			OnCellChanged(Idx, Run.PreviousState, Run.NewState);
+		}
+	}
+	GameState.State = Entry.NewState;
+
+	return true;
+}
+
+void FMinesweeperJournal::Reset()
+{
+	Runs.Reset();
+	Entries.Reset();
+	PendingChanges.Reset();
+	EntryCount = 0;
+}
+
+SIZE_T FMinesweeperJournal::GetAllocatedSize() const
+{
+	return Runs.GetAllocatedSize() + Entries.GetAllocatedSize() + PendingChanges.GetAllocatedSize();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperGame.h"
+
+/**
+ * Undo and redo history of a minesweeper game. Designed for:
+ * 1. Recording only the cells each move changed, never a copy of the whole board.
+ * 2. Run-length encoding consecutive cells changed the same way, which is what flood fill produces.
+ * 3. Undoing and redoing in time proportional to the cells the move changed.
+ */
+class FMinesweeperJournal
+{
+public:
+	FMinesweeperJournal();
+
+	/** Starts recording a move made while the game is in given state */
+	void BeginMove(EMinesweeperGameState State);
+
+	/** Records a cell changing state during the current move */
+	void RecordCellChange(int32 Idx, ECellState PreviousState, ECellState NewState);
+
+	/** Compacts the changes of the current move into a new entry and drops redo history. Returns false if nothing changed */
+	bool EndMove(EMinesweeperGameState State);
+
+	/** Invoked for every cell an undo or redo changes, with the state it leaves and the state it enters */
+	using FOnCellChanged = TFunctionRef<void(int32 Idx, ECellState PreviousState, ECellState NewState)>;
+
+	/** Reverts the last move. Returns false if there was nothing to undo */
+	bool Undo(FMinesweeperGameState& GameState, FOnCellChanged OnCellChanged);
+
+	/** Reapplies the last undone move. Returns false if there was nothing to redo */
+	bool Redo(FMinesweeperGameState& GameState, FOnCellChanged OnCellChanged);
+
+	/** Forgets all history, keeping allocated memory for the next game */
+	void Reset();
+
+	FORCEINLINE bool CanUndo() const
+	{
+		return EntryCount > 0;
+	}
+
+	FORCEINLINE bool CanRedo() const
+	{
+		return EntryCount < Entries.Num();
+	}
+
+	/** Memory held by the history, including redo entries */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	/** Consecutive cells that all went from PreviousState to NewState within one move */
+	struct FCellStateRun
+	{
+		int32      StartIdx;
+		uint16     Length;
+		ECellState PreviousState;
+		ECellState NewState;
+	};
+
+	struct FJournalEntry
+	{
+		int32                 FirstRun;
+		int32                 RunCount;
+		EMinesweeperGameState PreviousState;
+		EMinesweeperGameState NewState;
+	};
+
+	struct FCellChange
+	{
+		int32      Idx;
+		ECellState PreviousState;
+		ECellState NewState;
+	};
+
+private:
+	TArray<FCellStateRun> Runs;
+	TArray<FJournalEntry> Entries;
+
+	/** Entries before this index are applied, the rest can be redone */
+	int32 EntryCount;
+
+	/** Changes of the move being recorded, compacted into runs upon EndMove */
+	TArray<FCellChange>   PendingChanges;
+	EMinesweeperGameState PendingPreviousState;
+};
@@ -0,0 +1,236 @@
+#include "MinesweeperLatencyStats.h"
+#include "Misc/FileHelper.h"
+
+namespace
+{
+	uint64 CyclesToMicroseconds(uint64 StartCycles, uint64 EndCycles)
+	{
+		// Readings from different threads can come out of order by a few cycles
+		if (EndCycles <= StartCycles)
+		{
+			return 0;
+		}
+
+		return static_cast<uint64>(FPlatformTime::ToSeconds64(EndCycles - StartCycles) * 1e6);
+	}
+
+	double MicrosecondsToMilliseconds(uint64 Microseconds)
+	{
+		return Microseconds / 1000.0;
+	}
+
+	constexpr double PERCENTILES[] = {0.5, 0.95, 0.99};
+}
+
+FMinesweeperLatencyHistogram::FMinesweeperLatencyHistogram()
+{
+	Reset();
+}
+
+void FMinesweeperLatencyHistogram::Record(uint64 Microseconds)
+{
+	Counts[GetBucketIndex(Microseconds)].fetch_add(1, std::memory_order_relaxed);
+	TotalCount.fetch_add(1, std::memory_order_relaxed);
+
+	uint64 Max = MaxMicroseconds.load(std::memory_order_relaxed);
+	while (Microseconds > Max && !MaxMicroseconds.compare_exchange_weak(Max, Microseconds, std::memory_order_relaxed))
+	{
+	}
+}
+
+void FMinesweeperLatencyHistogram::Reset()
+{
+	for (std::atomic<uint32>& Count : Counts)
+	{
+		Count.store(0, std::memory_order_relaxed);
+	}
+
+	TotalCount.store(0, std::memory_order_relaxed);
+	MaxMicroseconds.store(0, std::memory_order_relaxed);
+}
+
+uint32 FMinesweeperLatencyHistogram::GetCount() const
+{
+	return TotalCount.load(std::memory_order_relaxed);
+}
+
+uint64 FMinesweeperLatencyHistogram::GetMax() const
+{
+	return MaxMicroseconds.load(std::memory_order_relaxed);
+}
+
+uint64 FMinesweeperLatencyHistogram::GetPercentile(double Fraction) const
+{
+	// Summing the buckets rather than trusting the total, which may be ahead of them while recording
+	uint64 BucketTotal = 0;
+	for (const std::atomic<uint32>& Count : Counts)
+	{
+		BucketTotal += Count.load(std::memory_order_relaxed);
+	}
+
+	if (BucketTotal == 0)
+	{
+		return 0;
+	}
+
+	const uint64 Rank = FMath::Max<uint64>(1, static_cast<uint64>(FMath::CeilToDouble(Fraction * BucketTotal)));
+	uint64 Seen = 0;
+	for (int32 BucketIdx = 0; BucketIdx < BUCKET_COUNT; ++BucketIdx)
+	{
+		Seen += Counts[BucketIdx].load(std::memory_order_relaxed);
+		if (Seen >= Rank)
+		{
+			return FMath::Min(GetBucketUpperBound(BucketIdx), GetMax());
+		}
+	}
+
+	return GetMax();
+}
+
+void FMinesweeperLatencyHistogram::AppendCsvBuckets(FString& Csv, const TCHAR* Phase) const
+{
+	for (int32 BucketIdx = 0; BucketIdx < BUCKET_COUNT; ++BucketIdx)
+	{
+		const uint32 Count = Counts[BucketIdx].load(std::memory_order_relaxed);
+		if (Count > 0)
+		{
+			Csv += FString::Printf(TEXT("%s,%llu,%llu,%u\n"),
+				Phase, GetBucketLowerBound(BucketIdx), GetBucketUpperBound(BucketIdx), Count);
+		}
+	}
+}
+
+int32 FMinesweeperLatencyHistogram::GetBucketIndex(uint64 Microseconds)
+{
+	const uint32 Value = static_cast<uint32>(FMath::Min<uint64>(Microseconds, MAX_uint32));
+	if (Value < LINEAR_BUCKET_COUNT)
+	{
+		return Value;
+	}
+
+	// Power of two picks the bucket group, the bits right below the leading one pick the bucket within
+	const int32 Exponent = FMath::FloorLog2(Value);
+	const int32 SubBucket = (Value >> (Exponent - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+	return LINEAR_BUCKET_COUNT + (Exponent - SUB_BUCKET_BITS - 1) * SUB_BUCKET_COUNT + SubBucket;
+}
+
+uint64 FMinesweeperLatencyHistogram::GetBucketLowerBound(int32 BucketIdx)
+{
+	if (BucketIdx < LINEAR_BUCKET_COUNT)
+	{
+		return BucketIdx;
+	}
+
+	const int32 Exponent = (BucketIdx - LINEAR_BUCKET_COUNT) / SUB_BUCKET_COUNT + SUB_BUCKET_BITS + 1;
+	const int32 SubBucket = (BucketIdx - LINEAR_BUCKET_COUNT) % SUB_BUCKET_COUNT;
+	return static_cast<uint64>(SUB_BUCKET_COUNT + SubBucket) << (Exponent - SUB_BUCKET_BITS);
+}
+
+uint64 FMinesweeperLatencyHistogram::GetBucketUpperBound(int32 BucketIdx)
+{
+	if (BucketIdx < LINEAR_BUCKET_COUNT)
+	{
+		return BucketIdx;
+	}
+
+	const int32 Exponent = (BucketIdx - LINEAR_BUCKET_COUNT) / SUB_BUCKET_COUNT + SUB_BUCKET_BITS + 1;
+	return GetBucketLowerBound(BucketIdx) + (1ull << (Exponent - SUB_BUCKET_BITS)) - 1;
+}
+
+FMinesweeperLatencyStats::FMinesweeperLatencyStats() :
+	PendingInputCycles{0},
+	PendingNotifyCycles{0}
+{
+}
+
+void FMinesweeperLatencyStats::Reset()
+{
+	for (FMinesweeperLatencyHistogram& Histogram : Histograms)
+	{
+		Histogram.Reset();
+	}
+
+	PendingNotifyCycles.store(0, std::memory_order_relaxed);
+}
+
+void FMinesweeperLatencyStats::RecordControllerTime(uint64 InputCycles, uint64 StartCycles, uint64 EndCycles)
+{
+	Histograms[static_cast<int32>(EPhase::Controller)].Record(CyclesToMicroseconds(StartCycles, EndCycles));
+
+	PendingInputCycles.store(InputCycles, std::memory_order_relaxed);
+	PendingNotifyCycles.store(EndCycles, std::memory_order_release);
+}
+
+void FMinesweeperLatencyStats::RecordViewTime(uint64 StartCycles, uint64 EndCycles)
+{
+	// Undo, redo and cascade slices after the first get drawn too, but they are not the response to an input
+	const uint64 NotifyCycles = PendingNotifyCycles.exchange(0, std::memory_order_acquire);
+	if (NotifyCycles == 0)
+	{
+		return;
+	}
+
+	const uint64 InputCycles = PendingInputCycles.load(std::memory_order_relaxed);
+
+	Histograms[static_cast<int32>(EPhase::Notification)].Record(CyclesToMicroseconds(NotifyCycles, StartCycles));
+	Histograms[static_cast<int32>(EPhase::View)].Record(CyclesToMicroseconds(StartCycles, EndCycles));
+	Histograms[static_cast<int32>(EPhase::Total)].Record(CyclesToMicroseconds(InputCycles, EndCycles));
+}
+
+FString FMinesweeperLatencyStats::ToSummaryString() const
+{
+	FString Summary = FString::Printf(TEXT("Moves: %u"), GetHistogram(EPhase::Total).GetCount());
+
+	for (int32 PhaseIdx = 0; PhaseIdx < static_cast<int32>(EPhase::Count); ++PhaseIdx)
+	{
+		const FMinesweeperLatencyHistogram& Histogram = Histograms[PhaseIdx];
+		Summary += FString::Printf(TEXT("\n%s: p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, worst %.2f ms"),
+			GetPhaseName(static_cast<EPhase>(PhaseIdx)),
+			MicrosecondsToMilliseconds(Histogram.GetPercentile(PERCENTILES[0])),
+			MicrosecondsToMilliseconds(Histogram.GetPercentile(PERCENTILES[1])),
+			MicrosecondsToMilliseconds(Histogram.GetPercentile(PERCENTILES[2])),
+			MicrosecondsToMilliseconds(Histogram.GetMax()));
+	}
+
+	return Summary;
+}
+
+bool FMinesweeperLatencyStats::ExportCsv(const FString& FilePath) const
+{
+	FString Csv = TEXT("Phase,Moves,P50Microseconds,P95Microseconds,P99Microseconds,WorstMicroseconds\n");
+	for (int32 PhaseIdx = 0; PhaseIdx < static_cast<int32>(EPhase::Count); ++PhaseIdx)
+	{
+		const FMinesweeperLatencyHistogram& Histogram = Histograms[PhaseIdx];
+		Csv += FString::Printf(TEXT("%s,%u,%llu,%llu,%llu,%llu\n"),
+			GetPhaseName(static_cast<EPhase>(PhaseIdx)),
+			Histogram.GetCount(),
+			Histogram.GetPercentile(PERCENTILES[0]),
+			Histogram.GetPercentile(PERCENTILES[1]),
+			Histogram.GetPercentile(PERCENTILES[2]),
+			Histogram.GetMax());
+	}
+
+	Csv += TEXT("\nPhase,LowerMicroseconds,UpperMicroseconds,Count\n");
+	for (int32 PhaseIdx = 0; PhaseIdx < static_cast<int32>(EPhase::Count); ++PhaseIdx)
+	{
+		Histograms[PhaseIdx].AppendCsvBuckets(Csv, GetPhaseName(static_cast<EPhase>(PhaseIdx)));
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *FilePath);
+}
+
+const TCHAR* FMinesweeperLatencyStats::GetPhaseName(EPhase Phase)
+{
+	switch (Phase)
+	{
+	case EPhase::Controller:
+		return TEXT("Controller");
+	case EPhase::Notification:
+		return TEXT("Notification");
+	case EPhase::View:
+		return TEXT("View");
+	case EPhase::Total:
+	default:
+		return TEXT("Total");
+	}
+}
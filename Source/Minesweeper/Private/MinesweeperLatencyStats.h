@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+ * Histogram of durations in microseconds, safe to record into from any thread without locking.
+ * Buckets are exact below LINEAR_BUCKET_COUNT microseconds, beyond that every power of two is split
+ * into SUB_BUCKET_COUNT buckets, which keeps percentiles within about 6% at a fixed size.
+ */
+class FMinesweeperLatencyHistogram
+{
+public:
+	static constexpr int32 SUB_BUCKET_BITS = 4;
+	static constexpr int32 SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+	static constexpr int32 LINEAR_BUCKET_COUNT = SUB_BUCKET_COUNT * 2;
+	static constexpr int32 BUCKET_COUNT = LINEAR_BUCKET_COUNT + (32 - SUB_BUCKET_BITS - 1) * SUB_BUCKET_COUNT;
+
+	FMinesweeperLatencyHistogram();
+
+	void Record(uint64 Microseconds);
+	void Reset();
+
+	uint32 GetCount() const;
+	uint64 GetMax() const;
+
+	/** Upper bound of the bucket holding given fraction of recorded durations, zero if none were recorded */
+	uint64 GetPercentile(double Fraction) const;
+
+	/** Appends a "Phase,LowerMicroseconds,UpperMicroseconds,Count" line for every bucket in use */
+	void AppendCsvBuckets(FString& Csv, const TCHAR* Phase) const;
+
+	static int32 GetBucketIndex(uint64 Microseconds);
+	static uint64 GetBucketLowerBound(int32 BucketIdx);
+	static uint64 GetBucketUpperBound(int32 BucketIdx);
+
+private:
+	std::atomic<uint32> Counts[BUCKET_COUNT];
+	std::atomic<uint32> TotalCount;
+	std::atomic<uint64> MaxMicroseconds;
+};
+
+/**
+ * Latency of every move of the current game, from player input until the grid widget got updated. Designed for:
+ * 1. Splitting each move into controller, notification and view time, so that each optimization can be checked
+ *    against the part it targets as well as the latency perceived by the player.
+ * 2. Recording from the controller and the view, whichever threads they run on.
+ * Only the move drawn last is tracked between controller and view. When the view skips worker snapshots,
+ * the moves it never drew only count towards controller time.
+ */
+class FMinesweeperLatencyStats
+{
+public:
+	enum class EPhase : uint8
+	{
+		/** Advancing the game upon player input */
+		Controller,
+		/** From the controller being done until the view starts updating, which includes any worker handover */
+		Notification,
+		/** Updating the grid widget */
+		View,
+		/** From player input until the grid widget got updated */
+		Total,
+		Count,
+	};
+
+	FMinesweeperLatencyStats();
+
+	/** Forgets every recorded move, upon a new game */
+	void Reset();
+
+	/** Controller thread. Records controller time of a move and hands the move over to the view */
+	void RecordControllerTime(uint64 InputCycles, uint64 StartCycles, uint64 EndCycles);
+
+	/** View thread. Completes the move handed over last, if there is one the view has not drawn yet */
+	void RecordViewTime(uint64 StartCycles, uint64 EndCycles);
+
+	const FMinesweeperLatencyHistogram& GetHistogram(EPhase Phase) const
+	{
+		return Histograms[static_cast<int32>(Phase)];
+	}
+
+	/** One line per phase with its percentiles and worst move */
+	FString ToSummaryString() const;
+
+	/** Saves percentiles and histogram buckets of every phase. Returns false if the file could not be written */
+	bool ExportCsv(const FString& FilePath) const;
+
+	static const TCHAR* GetPhaseName(EPhase Phase);
+
+private:
+	FMinesweeperLatencyHistogram Histograms[static_cast<int32>(EPhase::Count)];
+
+	/** Move the controller finished last, zero notify cycles once the view has drawn it */
+	std::atomic<uint64> PendingInputCycles;
+	std::atomic<uint64> PendingNotifyCycles;
+};
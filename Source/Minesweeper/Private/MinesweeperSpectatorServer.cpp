@@ -0,0 +1,449 @@
+#include "MinesweeperSpectatorServer.h"
+#include "MinesweeperGrid.h"
+#include "Common/TcpSocketBuilder.h"
+#include "HAL/RunnableThread.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+namespace
+{
+	/** Changes arriving within one tick go out as a single message */
+	constexpr uint32 SERVER_TICK_MILLISECONDS = 16;
+
+	/** Backlog of updates beyond which a spectator gets the whole board again rather than every update it missed */
+	constexpr int32 MAX_QUEUED_BYTES = 4 * 1024 * 1024;
+
+	constexpr int32 MAX_PENDING_CONNECTIONS = 8;
+
+	void WriteVarint(TArray<uint8>& Out, uint32 Value)
+	{
+		while (Value >= 0x80)
+		{
+			Out.Add(static_cast<uint8>(Value | 0x80));
+			Value >>= 7;
+		}
+		Out.Add(static_cast<uint8>(Value));
+	}
+
+	void WriteInt32(TArray<uint8>& Out, int32 Value)
+	{
+		const uint32 Bits = static_cast<uint32>(Value);
+		Out.Add(static_cast<uint8>(Bits));
+		Out.Add(static_cast<uint8>(Bits >> 8));
+		Out.Add(static_cast<uint8>(Bits >> 16));
+		Out.Add(static_cast<uint8>(Bits >> 24));
+	}
+
+	/** Run-length encodes cell codes, which cascades mostly leave as long stretches of zeros */
+	void WriteCodeRuns(TArray<uint8>& Out, const uint8* Codes, int32 Count)
+	{
+		for (int32 RunStart = 0; RunStart < Count;)
+		{
+			int32 RunEnd = RunStart + 1;
+			while (RunEnd < Count && Codes[RunEnd] == Codes[RunStart])
+			{
+				++RunEnd;
+			}
+
+			WriteVarint(Out, RunEnd - RunStart);
+			Out.Add(Codes[RunStart]);
+			RunStart = RunEnd;
+		}
+	}
+
+	/** Starts a message, whose size gets patched in by EndMessage */
+	void BeginMessage(TArray<uint8>& Out, FMinesweeperSpectatorServer::EMessageType Type)
+	{
+		WriteInt32(Out, 0);
+		Out.Add(static_cast<uint8>(Type));
+	}
+
+	void EndMessage(TArray<uint8>& Out)
+	{
+		const uint32 PayloadSize = Out.Num() - sizeof(uint32);
+		for (int32 Byte = 0; Byte < 4; ++Byte)
+		{
+			Out[Byte] = static_cast<uint8>(PayloadSize >> (Byte * 8));
+		}
+	}
+}
+
+FMinesweeperSpectatorServer::FMinesweeperSpectatorServer(int32 InPort) :
+	ListenSocket{nullptr},
+	WakeUpEvent{FPlatformProcess::GetSynchEventFromPool(false)},
+	Thread{nullptr},
+	bIsStopRequested{false},
+	Dimensions{0, 0, 0},
+	Topology{ETopology::Square},
+	Layout{ECellLayout::Linear},
+	State{EMinesweeperGameState::Running},
+	bIsStateDirty{false}
+{
+	// Loopback only, the stream is meant for tools on the same machine
+	ListenSocket = FTcpSocketBuilder(TEXT("MinesweeperSpectatorServer"))
+		.AsNonBlocking()
+		.AsReusable()
+		.BoundToEndpoint(FIPv4Endpoint(FIPv4Address(127, 0, 0, 1), InPort))
+		.Listening(MAX_PENDING_CONNECTIONS)
+		.Build();
+
+	if (!ListenSocket)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Minesweeper spectator server failed to listen on port %d."), InPort);
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Minesweeper spectator server listening on 127.0.0.1:%d."), InPort);
+	Thread = FRunnableThread::Create(this, TEXT("MinesweeperSpectatorServer"));
+}
+
+FMinesweeperSpectatorServer::~FMinesweeperSpectatorServer()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+	}
+
+	for (FSpectator& Spectator : Spectators)
+	{
+		CloseSpectator(Spectator);
+	}
+
+	if (ListenSocket)
+	{
+		ListenSocket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ListenSocket);
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeUpEvent);
+}
+
+void FMinesweeperSpectatorServer::HandleOnGameStarted(FMinesweeperGameConfig Config, const FMinesweeperGameState& GameState)
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	FBoardChange Change;
+	Change.bIsNewBoard = true;
+	Change.Dimensions = {Config.GridSize.X, Config.GridSize.Y, Config.GridDepth};
+	Change.Topology = Config.Topology;
+	Change.Layout = MinesweeperGrid::ResolveCellLayout(Config);
+	Change.State = GameState.State;
+
+	Change.CellCodes.SetNumUninitialized(GameState.Cells.Num());
+	for (int32 Idx = 0; Idx < GameState.Cells.Num(); ++Idx)
+	{
+		Change.CellCodes[Idx] = GetCellCode(GameState.Cells[Idx]);
+	}
+
+	BoardChanges.Enqueue(MoveTemp(Change));
+}
+
+void FMinesweeperSpectatorServer::HandleOnCellsChanged(const FMinesweeperGameState& GameState, TConstArrayView<int32> ChangedCells)
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	FBoardChange Change;
+	Change.bIsNewBoard = false;
+	Change.State = GameState.State;
+	Change.CellIndices.Append(ChangedCells.GetData(), ChangedCells.Num());
+
+	Change.CellCodes.SetNumUninitialized(ChangedCells.Num());
+	for (int32 ChangeIdx = 0; ChangeIdx < ChangedCells.Num(); ++ChangeIdx)
+	{
+		Change.CellCodes[ChangeIdx] = GetCellCode(GameState.Cells[ChangedCells[ChangeIdx]]);
+	}
+
+	// Not waking the server up, changes wait for its next tick to get batched
+	BoardChanges.Enqueue(MoveTemp(Change));
+}
+
+uint32 FMinesweeperSpectatorServer::Run()
+{
+	while (!bIsStopRequested.load())
+	{
+		AcceptSpectators();
+		ApplyBoardChanges();
+
+		if (Spectators.Num() > 0)
+		{
+			const FMessagePtr Update = EncodeUpdate();
+			FMessagePtr Board;
+
+			for (FSpectator& Spectator : Spectators)
+			{
+				// Board includes whatever the update carries, so it replaces the update
+				if (!Spectator.bNeedsBoard && Update)
+				{
+					Spectator.Outbox.Add(Update);
+					Spectator.QueuedBytes += Update->Num();
+
+					// Stalled spectator replaces whatever piled up behind its queued board with a fresh one
+					int32 BacklogBytes = Spectator.QueuedBytes;
+					if (Spectator.QueuedBoard)
+					{
+						Spectator.QueuedBoardUpdateBytes += Update->Num();
+						BacklogBytes = Spectator.QueuedBoardUpdateBytes;
+					}
+					Spectator.bNeedsBoard = BacklogBytes > MAX_QUEUED_BYTES;
+				}
+
+				if (Spectator.bNeedsBoard)
+				{
+					if (!Board)
+					{
+						Board = EncodeBoard();
+					}
+					SendBoard(Spectator, Board);
+				}
+			}
+
+			for (int32 SpectatorIdx = Spectators.Num() - 1; SpectatorIdx >= 0; --SpectatorIdx)
+			{
+				if (!FlushOutbox(Spectators[SpectatorIdx]))
+				{
+					CloseSpectator(Spectators[SpectatorIdx]);
+					Spectators.RemoveAtSwap(SpectatorIdx);
+				}
+			}
+		}
+
+		ClearDirtyCells();
+		WakeUpEvent->Wait(SERVER_TICK_MILLISECONDS);
+	}
+
+	return 0;
+}
+
+void FMinesweeperSpectatorServer::Stop()
+{
+	bIsStopRequested.store(true);
+	WakeUpEvent->Trigger();
+}
+
+uint8 FMinesweeperSpectatorServer::GetCellCode(const FMineCell& Cell)
+{
+	switch (Cell.CellState)
+	{
+	case ECellState::Hidden:
+		return CELL_CODE_HIDDEN;
+	case ECellState::Exploded:
+		return CELL_CODE_EXPLODED;
+	case ECellState::Flagged:
+		return CELL_CODE_FLAGGED;
+	default:
+		return Cell.IsMine() ? CELL_CODE_MINE : static_cast<uint8>(Cell.NeighborMineCount);
+	}
+}
+
+void FMinesweeperSpectatorServer::AcceptSpectators()
+{
+	bool bHasPendingConnection = false;
+	while (ListenSocket->HasPendingConnection(bHasPendingConnection) && bHasPendingConnection)
+	{
+		FSocket* Socket = ListenSocket->Accept(TEXT("MinesweeperSpectator"));
+		if (!Socket)
+		{
+			break;
+		}
+
+		Socket->SetNonBlocking(true);
+		Socket->SetNoDelay(true);
+		Spectators.Add({Socket, {}, 0, 0, true, nullptr, 0});
+	}
+}
+
+void FMinesweeperSpectatorServer::ApplyBoardChanges()
+{
+	FBoardChange Change;
+	while (BoardChanges.Dequeue(Change))
+	{
+		if (Change.bIsNewBoard)
+		{
+			Dimensions = Change.Dimensions;
+			Topology = Change.Topology;
+			Layout = Change.Layout;
+			State = Change.State;
+			CellCodes = MoveTemp(Change.CellCodes);
+
+			DirtyCells.Init(false, CellCodes.Num());
+			DirtyIndices.Reset();
+			bIsStateDirty = false;
+
+			for (FSpectator& Spectator : Spectators)
+			{
+				Spectator.bNeedsBoard = true;
+			}
+			continue;
+		}
+
+		bIsStateDirty |= State != Change.State;
+		State = Change.State;
+
+		for (int32 ChangeIdx = 0; ChangeIdx < Change.CellIndices.Num(); ++ChangeIdx)
+		{
+			const int32 Idx = Change.CellIndices[ChangeIdx];
+			CellCodes[Idx] = Change.CellCodes[ChangeIdx];
+
+			if (!DirtyCells[Idx])
+			{
+				DirtyCells[Idx] = true;
+				DirtyIndices.Add(Idx);
+			}
+		}
+	}
+}
+
+FMinesweeperSpectatorServer::FMessagePtr FMinesweeperSpectatorServer::EncodeBoard() const
+{
+	TSharedRef<TArray<uint8>> Message = MakeShared<TArray<uint8>>();
+
+	BeginMessage(*Message, EMessageType::Board);
+	WriteInt32(*Message, Dimensions.X);
+	WriteInt32(*Message, Dimensions.Y);
+	WriteInt32(*Message, Dimensions.Z);
+	Message->Add(static_cast<uint8>(Topology));
+	Message->Add(static_cast<uint8>(Layout));
+	Message->Add(static_cast<uint8>(State));
+	WriteCodeRuns(*Message, CellCodes.GetData(), CellCodes.Num());
+	EndMessage(*Message);
+
+	return Message;
+}
+
+FMinesweeperSpectatorServer::FMessagePtr FMinesweeperSpectatorServer::EncodeUpdate() const
+{
+	if (DirtyIndices.Num() == 0 && !bIsStateDirty)
+	{
+		return nullptr;
+	}
+
+	// Sorting only the changed cells, not scanning the board, keeps the update proportional to the move
+	TArray<int32> SortedIndices = DirtyIndices;
+	SortedIndices.Sort();
+
+	TArray<TPair<int32, int32>, TInlineAllocator<64>> Ranges;
+	for (int32 RangeStart = 0; RangeStart < SortedIndices.Num();)
+	{
+		int32 RangeEnd = RangeStart + 1;
+		while (RangeEnd < SortedIndices.Num() && SortedIndices[RangeEnd] == SortedIndices[RangeEnd - 1] + 1)
+		{
+			++RangeEnd;
+		}
+
+		Ranges.Emplace(SortedIndices[RangeStart], RangeEnd - RangeStart);
+		RangeStart = RangeEnd;
+	}
+
+	TSharedRef<TArray<uint8>> Message = MakeShared<TArray<uint8>>();
+
+	BeginMessage(*Message, EMessageType::Update);
+	Message->Add(static_cast<uint8>(State));
+	WriteVarint(*Message, Ranges.Num());
+
+	int32 PreviousRangeEnd = 0;
+	for (const TPair<int32, int32>& Range : Ranges)
+	{
+		WriteVarint(*Message, Range.Key - PreviousRangeEnd);
+		WriteVarint(*Message, Range.Value);
+		WriteCodeRuns(*Message, CellCodes.GetData() + Range.Key, Range.Value);
+		PreviousRangeEnd = Range.Key + Range.Value;
+	}
+
+	EndMessage(*Message);
+
+	return Message;
+}
+
+void FMinesweeperSpectatorServer::ClearDirtyCells()
+{
+	for (const int32 Idx : DirtyIndices)
+	{
+		DirtyCells[Idx] = false;
+	}
+
+	DirtyIndices.Reset();
+	bIsStateDirty = false;
+}
+
+void FMinesweeperSpectatorServer::SendBoard(FSpectator& Spectator, const FMessagePtr& Board)
+{
+	// Message partially sent already has to go out whole, anything queued behind it is superseded by the board
+	const int32 KeptCount = Spectator.SentBytes > 0 ? 1 : 0;
+	Spectator.Outbox.SetNum(KeptCount, false);
+	Spectator.QueuedBytes = KeptCount > 0 ? Spectator.Outbox[0]->Num() - Spectator.SentBytes : 0;
+
+	Spectator.Outbox.Add(Board);
+	Spectator.QueuedBytes += Board->Num();
+	Spectator.bNeedsBoard = false;
+	Spectator.QueuedBoard = Board;
+	Spectator.QueuedBoardUpdateBytes = 0;
+}
+
+bool FMinesweeperSpectatorServer::FlushOutbox(FSpectator& Spectator)
+{
+	if (Spectator.Socket->GetConnectionState() == SCS_ConnectionError)
+	{
+		return false;
+	}
+
+	int32 SentCount = 0;
+	for (; SentCount < Spectator.Outbox.Num(); ++SentCount)
+	{
+		const TArray<uint8>& Message = *Spectator.Outbox[SentCount];
+
+		while (Spectator.SentBytes < Message.Num())
+		{
+			int32 BytesSent = 0;
+			const bool bHasSent = Spectator.Socket->Send(
+				Message.GetData() + Spectator.SentBytes, Message.Num() - Spectator.SentBytes, BytesSent);
+
+			if (!bHasSent)
+			{
+				// Full socket buffer is a slow spectator, anything else is a gone one
+				const ESocketErrors Error = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+				if (Error != SE_EWOULDBLOCK)
+				{
+					return false;
+				}
+				break;
+			}
+
+			if (BytesSent <= 0)
+			{
+				break;
+			}
+
+			Spectator.SentBytes += BytesSent;
+			Spectator.QueuedBytes -= BytesSent;
+		}
+
+		if (Spectator.SentBytes < Message.Num())
+		{
+			break;
+		}
+
+		if (Spectator.Outbox[SentCount] == Spectator.QueuedBoard)
+		{
+			Spectator.QueuedBoard.Reset();
+		}
+		Spectator.SentBytes = 0;
+	}
+
+	Spectator.Outbox.RemoveAt(0, SentCount, false);
+	return true;
+}
+
+void FMinesweeperSpectatorServer::CloseSpectator(FSpectator& Spectator)
+{
+	Spectator.Socket->Close();
+	ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Spectator.Socket);
+	Spectator.Socket = nullptr;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperGame.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include <atomic>
+
+class FSocket;
+
+/**
+ * Streams the game to spectating tools, such as dashboards or recorders, over a loopback socket. Designed for:
+ * 1. Sending the whole board once per game and spectator, after that only the cells that changed.
+ * 2. Batching changes per server tick into a single message, shared by every spectator that is up to date.
+ * 3. Never blocking the thread running the controller, which only hands changes over through a lock-free queue.
+ * A spectator falling too far behind on updates gets its backlog dropped and the whole board sent again instead,
+ * once the board it got last has gone out, however large that one was.
+ *
+ * Every message is a little-endian uint32 payload size followed by the payload, starting with the message type.
+ * Cells are addressed by storage index, which keeps cascades in consecutive ranges on tiled and Morton layouts.
+ * Varints are unsigned LEB128, and a code run is a varint cell count followed by the cell code they share.
+ * Board:  type, int32 width, height and depth, uint8 topology, uint8 cell layout, uint8 game state,
+ *         then code runs covering every cell.
+ * Update: type, uint8 game state, varint range count, then for every range of consecutive changed cells
+ *         varint gap since the end of previous range, varint length, and code runs covering the range.
+ */
+class FMinesweeperSpectatorServer : public FRunnable
+{
+public:
+	enum class EMessageType : uint8
+	{
+		Board,
+		Update,
+	};
+
+	/** Codes below these are revealed cells with that many neighboring mines */
+	static constexpr uint8 CELL_CODE_HIDDEN = 0x80;
+	static constexpr uint8 CELL_CODE_MINE = 0x81;
+	static constexpr uint8 CELL_CODE_EXPLODED = 0x82;
+	static constexpr uint8 CELL_CODE_FLAGGED = 0x83;
+
+	explicit FMinesweeperSpectatorServer(int32 InPort);
+	virtual ~FMinesweeperSpectatorServer() override;
+
+	FMinesweeperSpectatorServer(const FMinesweeperSpectatorServer&) = delete;
+	FMinesweeperSpectatorServer& operator=(const FMinesweeperSpectatorServer&) = delete;
+
+	/** Thread running the controller. Sends the whole board to every spectator. Does nothing if the port could not be bound */
+	void HandleOnGameStarted(FMinesweeperGameConfig Config, const FMinesweeperGameState& GameState);
+
+	/** Thread running the controller. Sends given cells to every spectator, in time proportional to their count */
+	void HandleOnCellsChanged(const FMinesweeperGameState& GameState, TConstArrayView<int32> ChangedCells);
+
+	/** FRunnable implementation */
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	/** Handed over from the controller thread, either a whole new board or the cells changed on the current one */
+	struct FBoardChange
+	{
+		bool                  bIsNewBoard;
+		FIntVector            Dimensions;
+		ETopology             Topology;
+		ECellLayout           Layout;
+		EMinesweeperGameState State;
+		TArray<int32>         CellIndices;
+		TArray<uint8>         CellCodes;
+	};
+
+	/** Encoded once and shared by the outboxes of every spectator it is sent to */
+	using FMessagePtr = TSharedPtr<const TArray<uint8>>;
+
+	struct FSpectator
+	{
+		FSocket*            Socket;
+		TArray<FMessagePtr> Outbox;
+		/** Bytes of the first outbox message already sent */
+		int32               SentBytes;
+		int32               QueuedBytes;
+		bool                bNeedsBoard;
+		/** Board still in the outbox, while it is there the backlog is only the updates queued behind it */
+		FMessagePtr         QueuedBoard;
+		int32               QueuedBoardUpdateBytes;
+	};
+
+	static uint8 GetCellCode(const FMineCell& Cell);
+
+	/** Server thread only */
+	void AcceptSpectators();
+	void ApplyBoardChanges();
+	FMessagePtr EncodeBoard() const;
+	FMessagePtr EncodeUpdate() const;
+	void ClearDirtyCells();
+	void SendBoard(FSpectator& Spectator, const FMessagePtr& Board);
+	bool FlushOutbox(FSpectator& Spectator);
+	void CloseSpectator(FSpectator& Spectator);
+
+private:
+	FSocket*           ListenSocket;
+	FEvent*            WakeUpEvent;
+	FRunnableThread*   Thread;
+	std::atomic<bool>  bIsStopRequested;
+
+	TQueue<FBoardChange, EQueueMode::Mpsc> BoardChanges;
+
+	/** Server thread only, the board as spectators are meant to see it by the end of current tick */
+	TArray<FSpectator>    Spectators;
+	FIntVector            Dimensions;
+	ETopology             Topology;
+	ECellLayout           Layout;
+	EMinesweeperGameState State;
+	TArray<uint8>         CellCodes;
+
+	/** Server thread only, what changed since previous tick */
+	TBitArray<>   DirtyCells;
+	TArray<int32> DirtyIndices;
+	bool          bIsStateDirty;
+};
@@ -0,0 +1,413 @@
+#include "MinesweeperStatsStore.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+	/** Queued games get written in batches at this interval */
+	constexpr uint32 WRITER_TICK_MILLISECONDS = 100;
+
+	/** The index gets saved at most this often while games keep coming, and once more upon shutdown */
+	constexpr double INDEX_SAVE_INTERVAL_SECONDS = 5.0;
+
+	/** Records read at once when catching up with the log */
+	constexpr int64 CATCH_UP_CHUNK_RECORD_COUNT = 4096;
+
+	uint32 ToMilliseconds(double Seconds)
+	{
+		return static_cast<uint32>(FMath::Clamp(Seconds * 1000.0, 0.0, static_cast<double>(MAX_uint32)));
+	}
+
+	/** Reads or writes one record in the layout of the log, RECORD_SIZE bytes either way */
+	void SerializeRecord(FArchive& Ar, FMinesweeperGameRecord& Record)
+	{
+		FMinesweeperGameConfig& Config = Record.Config;
+
+		int32 Seed = Config.RandomSeed.Get(0);
+		uint8 Topology = static_cast<uint8>(Config.Topology);
+		uint8 Generation = static_cast<uint8>(Config.Generation);
+		uint8 Layout = static_cast<uint8>(Config.Layout);
+		uint8 Outcome = static_cast<uint8>(Record.Outcome);
+		int64 FinishTicks = Record.FinishTime.GetTicks();
+		uint32 DurationMilliseconds = ToMilliseconds(Record.DurationSeconds);
+		int32 TargetThreeBVMin = Config.TargetThreeBV ? Config.TargetThreeBV->Min : INDEX_NONE;
+		int32 TargetThreeBVMax = Config.TargetThreeBV ? Config.TargetThreeBV->Max : INDEX_NONE;
+
+		Ar << Config.GridSize.X << Config.GridSize.Y << Config.GridDepth << Config.MineCount << Seed;
+		Ar << Topology << Generation << Layout << Outcome;
+		Ar << FinishTicks << DurationMilliseconds << Record.ThreeBV << Record.MoveCount;
+		Ar << Record.StartIdx << TargetThreeBVMin << TargetThreeBVMax;
+
+		if (Ar.IsLoading())
+		{
+			Config.RandomSeed = Seed;
+			Config.Topology = static_cast<ETopology>(Topology);
+			Config.Generation = static_cast<EMineGeneration>(Generation);
+			Config.Layout = static_cast<ECellLayout>(Layout);
+			Record.Outcome = static_cast<EMinesweeperGameState>(Outcome);
+			Record.FinishTime = FDateTime{FinishTicks};
+			Record.DurationSeconds = DurationMilliseconds / 1000.0;
+
+			if (TargetThreeBVMin != INDEX_NONE)
+			{
+				Config.TargetThreeBV = FInt32Interval{TargetThreeBVMin, TargetThreeBVMax};
+			}
+			else
+			{
+				Config.TargetThreeBV.Reset();
+			}
+		}
+	}
+
+	void SerializeIndexEntry(FArchive& Ar, FMinesweeperStatsKey& Key, FMinesweeperConfigStats& Stats)
+	{
+		uint8 Topology = static_cast<uint8>(Key.Topology);
+		uint8 Generation = static_cast<uint8>(Key.Generation);
+
+		Ar << Key.Dimensions.X << Key.Dimensions.Y << Key.Dimensions.Z << Key.MineCount << Topology << Generation;
+		Ar << Stats.GameCount << Stats.WinCount << Stats.BestWinMilliseconds << Stats.TotalWinMilliseconds;
+
+		if (Ar.IsLoading())
+		{
+			Key.Topology = static_cast<ETopology>(Topology);
+			Key.Generation = static_cast<EMineGeneration>(Generation);
+		}
+	}
+
+	template <typename IndexType>
+	void AddToIndex(IndexType& Index, const FMinesweeperGameRecord& Record)
+	{
+		FMinesweeperConfigStats& Stats = Index.FindOrAdd(FMinesweeperStatsKey::FromConfig(Record.Config));
+		++Stats.GameCount;
+
+		if (Record.Outcome == EMinesweeperGameState::GameOver_Win)
+		{
+			const uint32 DurationMilliseconds = ToMilliseconds(Record.DurationSeconds);
+			++Stats.WinCount;
+			Stats.BestWinMilliseconds = FMath::Min(Stats.BestWinMilliseconds, DurationMilliseconds);
+			Stats.TotalWinMilliseconds += DurationMilliseconds;
+		}
+	}
+}
+
+FMinesweeperStatsKey FMinesweeperStatsKey::FromConfig(const FMinesweeperGameConfig& Config)
+{
+	return FMinesweeperStatsKey{{Config.GridSize.X, Config.GridSize.Y, Config.GridDepth}, Config.MineCount, Config.Topology, Config.Generation};
+}
+
+FMinesweeperStatsStore::FMinesweeperStatsStore(const FString& InDirectory) :
+	LogPath{InDirectory / TEXT("GameStats.bin")},
+	IndexPath{InDirectory / TEXT("GameStats.idx")},
+	WakeUpEvent{FPlatformProcess::GetSynchEventFromPool(false)},
+	Thread{nullptr},
+	bIsStopRequested{false},
+	Revision{0},
+	LogRecordCount{0},
+	SavedRecordCount{0},
+	LastSaveSeconds{0.0}
+{
+	Thread = FRunnableThread::Create(this, TEXT("MinesweeperStatsStore"), 0, TPri_BelowNormal);
+}
+
+FMinesweeperStatsStore::~FMinesweeperStatsStore()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeUpEvent);
+}
+
+void FMinesweeperStatsStore::HandleOnGameFinished(const FMinesweeperGameRecord& Record)
+{
+	if (Thread)
+	{
+		QueuedRecords.Enqueue(Record);
+	}
+}
+
+FMinesweeperConfigStats FMinesweeperStatsStore::GetStats(const FMinesweeperGameConfig& Config) const
+{
+	FScopeLock Lock{&IndexLock};
+
+	const FMinesweeperConfigStats* Stats = Index.Find(FMinesweeperStatsKey::FromConfig(Config));
+	return Stats ? *Stats : FMinesweeperConfigStats{};
+}
+
+uint32 FMinesweeperStatsStore::Run()
+{
+	if (OpenLog())
+	{
+		LoadIndex();
+		CatchUpIndex();
+	}
+
+	while (!bIsStopRequested.load())
+	{
+		WakeUpEvent->Wait(WRITER_TICK_MILLISECONDS);
+		AppendQueuedRecords();
+
+		const bool bIsIndexDirty = LogRecordCount != SavedRecordCount;
+		if (bIsIndexDirty && FPlatformTime::Seconds() - LastSaveSeconds >= INDEX_SAVE_INTERVAL_SECONDS)
+		{
+			SaveIndex();
+		}
+	}
+
+	// Games finished right before shutdown still make it into the log
+	AppendQueuedRecords();
+	if (LogRecordCount != SavedRecordCount)
+	{
+		SaveIndex();
+	}
+
+	LogFile.Reset();
+	return 0;
+}
+
+void FMinesweeperStatsStore::Stop()
+{
+	bIsStopRequested.store(true);
+	WakeUpEvent->Trigger();
+}
+
+bool FMinesweeperStatsStore::OpenLog()
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(LogPath));
+
+	LogFile.Reset(PlatformFile.OpenWrite(*LogPath, true, true));
+	if (!LogFile)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Minesweeper game stats could not open %s, games will not be kept."), *LogPath);
+		return false;
+	}
+
+	const int64 LogSize = LogFile->Size();
+
+	// New log, or one whose header never made it to disk
+	if (LogSize < LOG_HEADER_SIZE)
+	{
+		TArray<uint8> Header;
+		FMemoryWriter Writer{Header};
+		uint32 Magic = LOG_MAGIC;
+		uint32 Version = VERSION;
+		Writer << Magic << Version;
+
+		LogFile->Truncate(0);
+		LogFile->Seek(0);
+		if (!LogFile->Write(Header.GetData(), Header.Num()))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Minesweeper game stats failed to write %s, games will not be kept."), *LogPath);
+			LogFile.Reset();
+			return false;
+		}
+
+		LogRecordCount = 0;
+		return true;
+	}
+
+	TArray<uint8> Header;
+	Header.SetNumUninitialized(LOG_HEADER_SIZE);
+	LogFile->Seek(0);
+	LogFile->Read(Header.GetData(), Header.Num());
+
+	FMemoryReader Reader{Header};
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Reader << Magic << Version;
+
+	// Never overwriting a log this version does not understand
+	if (Magic != LOG_MAGIC || Version != VERSION)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Minesweeper game stats found an unknown log at %s, games will not be kept."), *LogPath);
+		LogFile.Reset();
+		return false;
+	}
+
+	// Dropping a record cut short, so that the next one starts at its own offset
+	LogRecordCount = (LogSize - LOG_HEADER_SIZE) / RECORD_SIZE;
+	const int64 ValidSize = LOG_HEADER_SIZE + LogRecordCount * RECORD_SIZE;
+	if (ValidSize != LogSize)
+	{
+		LogFile->Truncate(ValidSize);
+	}
+
+	LogFile->Seek(ValidSize);
+	return true;
+}
+
+void FMinesweeperStatsStore::LoadIndex()
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *IndexPath, FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader{Bytes};
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	int64 RecordCount = 0;
+	int32 EntryCount = 0;
+	Reader << Magic << Version << RecordCount << EntryCount;
+
+	// An index saved for more records than the log holds belongs to another log, so the log gets indexed anew
+	if (Reader.IsError() || Magic != INDEX_MAGIC || Version != VERSION || RecordCount > LogRecordCount || EntryCount < 0)
+	{
+		return;
+	}
+
+	FStatsIndex LoadedIndex;
+	LoadedIndex.Reserve(EntryCount);
+	for (int32 EntryIdx = 0; EntryIdx < EntryCount && !Reader.IsError(); ++EntryIdx)
+	{
+		FMinesweeperStatsKey Key;
+		FMinesweeperConfigStats Stats;
+		SerializeIndexEntry(Reader, Key, Stats);
+		LoadedIndex.Add(Key, Stats);
+	}
+
+	if (Reader.IsError())
+	{
+		return;
+	}
+
+	FScopeLock Lock{&IndexLock};
+	Index = MoveTemp(LoadedIndex);
+	SavedRecordCount = RecordCount;
+}
+
+void FMinesweeperStatsStore::CatchUpIndex()
+{
+	TArray<uint8> Chunk;
+	LogFile->Seek(LOG_HEADER_SIZE + SavedRecordCount * RECORD_SIZE);
+
+	for (int64 RecordIdx = SavedRecordCount; RecordIdx < LogRecordCount;)
+	{
+		const int64 ChunkRecordCount = FMath::Min(CATCH_UP_CHUNK_RECORD_COUNT, LogRecordCount - RecordIdx);
+		Chunk.SetNumUninitialized(ChunkRecordCount * RECORD_SIZE);
+
+		if (!LogFile->Read(Chunk.GetData(), Chunk.Num()))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Minesweeper game stats failed to read %s, games will not be kept."), *LogPath);
+			LogFile.Reset();
+			break;
+		}
+
+		FMemoryReader Reader{Chunk};
+		FScopeLock Lock{&IndexLock};
+		for (int64 ChunkRecordIdx = 0; ChunkRecordIdx < ChunkRecordCount; ++ChunkRecordIdx)
+		{
+			FMinesweeperGameRecord Record;
+			SerializeRecord(Reader, Record);
+			AddToIndex(Index, Record);
+		}
+
+		RecordIdx += ChunkRecordCount;
+	}
+
+	Revision.fetch_add(1, std::memory_order_release);
+
+	if (LogFile)
+	{
+		LogFile->Seek(LOG_HEADER_SIZE + LogRecordCount * RECORD_SIZE);
+		if (LogRecordCount != SavedRecordCount)
+		{
+			SaveIndex();
+		}
+	}
+}
+
+void FMinesweeperStatsStore::AppendQueuedRecords()
+{
+	Batch.Reset();
+	FMinesweeperGameRecord Record;
+	while (QueuedRecords.Dequeue(Record))
+	{
+		Batch.Add(Record);
+	}
+
+	if (Batch.Num() == 0)
+	{
+		return;
+	}
+
+	// One write for the whole batch, however many games the simulators finished since the last one
+	if (LogFile)
+	{
+		WriteBuffer.Reset();
+		FMemoryWriter Writer{WriteBuffer};
+		for (FMinesweeperGameRecord& BatchRecord : Batch)
+		{
+			SerializeRecord(Writer, BatchRecord);
+		}
+
+		check(WriteBuffer.Num() == Batch.Num() * RECORD_SIZE);
+		if (LogFile->Write(WriteBuffer.GetData(), WriteBuffer.Num()))
+		{
+			LogRecordCount += Batch.Num();
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Minesweeper game stats failed to write %s, games will not be kept."), *LogPath);
+			LogFile.Reset();
+		}
+	}
+
+	// Games that could not be kept still count until the editor closes
+	{
+		FScopeLock Lock{&IndexLock};
+		for (const FMinesweeperGameRecord& BatchRecord : Batch)
+		{
+			AddToIndex(Index, BatchRecord);
+		}
+	}
+
+	Revision.fetch_add(1, std::memory_order_release);
+}
+
+void FMinesweeperStatsStore::SaveIndex()
+{
+	// The index must never cover records that are not on disk yet
+	if (!LogFile || !LogFile->Flush())
+	{
+		return;
+	}
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer{Bytes};
+	uint32 Magic = INDEX_MAGIC;
+	uint32 Version = VERSION;
+	int64 RecordCount = LogRecordCount;
+	int32 EntryCount = Index.Num();
+	Writer << Magic << Version << RecordCount << EntryCount;
+
+	// Only this thread writes the index, so reading it needs no lock
+	for (const TPair<FMinesweeperStatsKey, FMinesweeperConfigStats>& Entry : Index)
+	{
+		FMinesweeperStatsKey Key = Entry.Key;
+		FMinesweeperConfigStats Stats = Entry.Value;
+		SerializeIndexEntry(Writer, Key, Stats);
+	}
+
+	// Replacing the previous index at once, so that a crash while saving leaves it intact
+	const FString TempPath = IndexPath + TEXT(".tmp");
+	if (FFileHelper::SaveArrayToFile(Bytes, *TempPath) && IFileManager::Get().Move(*IndexPath, *TempPath, true))
+	{
+		SavedRecordCount = LogRecordCount;
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Minesweeper game stats failed to save %s."), *IndexPath);
+	}
+
+	LastSaveSeconds = FPlatformTime::Seconds();
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperGame.h"
+#include "HAL/Runnable.h"
+#include "Containers/Queue.h"
+#include <atomic>
+
+class IFileHandle;
+
+/** Games played with one board size, mine count, topology and generation, whatever their seed */
+struct FMinesweeperStatsKey
+{
+	FIntVector      Dimensions;
+	int32           MineCount;
+	ETopology       Topology;
+	EMineGeneration Generation;
+
+	static FMinesweeperStatsKey FromConfig(const FMinesweeperGameConfig& Config);
+
+	FORCEINLINE bool operator==(const FMinesweeperStatsKey& Other) const
+	{
+		return Dimensions == Other.Dimensions && MineCount == Other.MineCount
+			&& Topology == Other.Topology && Generation == Other.Generation;
+	}
+
+	friend FORCEINLINE uint32 GetTypeHash(const FMinesweeperStatsKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.Dimensions), GetTypeHash(Key.MineCount)),
+			GetTypeHash(static_cast<uint8>(Key.Topology) | static_cast<uint8>(Key.Generation) << 4));
+	}
+};
+
+struct FMinesweeperConfigStats
+{
+	uint32 GameCount = 0;
+	uint32 WinCount = 0;
+	/** Fastest win, MAX_uint32 until the first one */
+	uint32 BestWinMilliseconds = MAX_uint32;
+	uint64 TotalWinMilliseconds = 0;
+
+	FORCEINLINE bool HasWin() const
+	{
+		return WinCount > 0;
+	}
+
+	FORCEINLINE double GetWinRate() const
+	{
+		return GameCount > 0 ? static_cast<double>(WinCount) / GameCount : 0.0;
+	}
+};
+
+/**
+ * Statistics of every game ever finished, kept under the Saved directory of the project. Designed for:
+ * 1. Appending games in constant time from whichever thread finishes them, a background writer doing all file access.
+ * 2. Answering queries per config from an index in memory, never reading the log for them.
+ * 3. Opening in time proportional to the configs played rather than the games, the index being saved alongside
+ *    the log along with how many records it covers, so only records appended after it was saved get read again.
+ *
+ * The log is a little-endian header, uint32 magic and version, followed by records of RECORD_SIZE bytes:
+ * int32 width, height, depth, mine count and seed, uint8 topology, generation, layout and outcome,
+ * int64 finish time in UTC ticks, uint32 duration in milliseconds, int32 3BV and move count,
+ * int32 start index, target 3BV minimum and maximum, INDEX_NONE when the game had none.
+ * Along with the seed, these are what it takes to generate the board of a game again.
+ * A record cut short by a crash gets dropped when the log is opened again.
+ */
+class FMinesweeperStatsStore : public FRunnable
+{
+public:
+	static constexpr uint32 LOG_MAGIC = 0x4C47534D;
+	static constexpr uint32 INDEX_MAGIC = 0x5849534D;
+	static constexpr uint32 VERSION = 2;
+	static constexpr int64 LOG_HEADER_SIZE = 8;
+	static constexpr int64 RECORD_SIZE = 56;
+
+	/** Reads the index and the log from files in given directory on the background writer, created if missing */
+	explicit FMinesweeperStatsStore(const FString& InDirectory);
+	virtual ~FMinesweeperStatsStore() override;
+
+	FMinesweeperStatsStore(const FMinesweeperStatsStore&) = delete;
+	FMinesweeperStatsStore& operator=(const FMinesweeperStatsStore&) = delete;
+
+	/** Any thread. Queues a finished game for the writer without waiting on it */
+	void HandleOnGameFinished(const FMinesweeperGameRecord& Record);
+
+	/** Any thread. Stats of every game of the config indexed so far, empty until the index is loaded */
+	FMinesweeperConfigStats GetStats(const FMinesweeperGameConfig& Config) const;
+
+	/** Any thread. Changes whenever the index does, for views to refresh upon */
+	FORCEINLINE uint32 GetRevision() const
+	{
+		return Revision.load(std::memory_order_acquire);
+	}
+
+	/** FRunnable implementation */
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	using FStatsIndex = TMap<FMinesweeperStatsKey, FMinesweeperConfigStats>;
+
+	/** Writer thread only */
+	bool OpenLog();
+	void LoadIndex();
+	void CatchUpIndex();
+	void AppendQueuedRecords();
+	void SaveIndex();
+
+private:
+	FString LogPath;
+	FString IndexPath;
+
+	FEvent*           WakeUpEvent;
+	FRunnableThread*  Thread;
+	std::atomic<bool> bIsStopRequested;
+
+	TQueue<FMinesweeperGameRecord, EQueueMode::Mpsc> QueuedRecords;
+
+	/** Written by the writer thread, read by queries */
+	mutable FCriticalSection IndexLock;
+	FStatsIndex              Index;
+	std::atomic<uint32>      Revision;
+
+	/** Writer thread only */
+	TUniquePtr<IFileHandle>        LogFile;
+	int64                          LogRecordCount;
+	/** Records of the log the index on disk covers */
+	int64                          SavedRecordCount;
+	double                         LastSaveSeconds;
+	TArray<FMinesweeperGameRecord> Batch;
+	TArray<uint8>                  WriteBuffer;
+};
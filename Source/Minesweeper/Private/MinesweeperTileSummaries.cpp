@@ -0,0 +1,50 @@
+#include "MinesweeperTileSummaries.h"
+
+void FMinesweeperTileSummaries::Build(const TArray<FMineCell>& Cells, FMinesweeperGameArena& Arena)
+{
+	CellCount = Cells.Num();
+
+	const int32 TileCount = (CellCount + TILE_CELL_COUNT - 1) >> TILE_SHIFT;
+	RevealedCounts = Arena.Allocate<uint8>(TileCount);
+	AllRevealedFlags = Arena.Allocate<bool>(TileCount);
+	ContainsMineFlags = Arena.Allocate<bool>(TileCount);
+
+	for (int32 Tile = 0; Tile < TileCount; ++Tile)
+	{
+		int32 RevealedCount = 0;
+		bool bContainsMine = false;
+
+		const int32 TileEnd = GetTileEnd(Tile);
+		for (int32 Idx = GetTileStart(Tile); Idx < TileEnd; ++Idx)
+		{
+			RevealedCount += !Cells[Idx].IsHidden() && !Cells[Idx].IsFlagged();
+			bContainsMine |= Cells[Idx].IsMine();
+		}
+
+		RevealedCounts[Tile] = static_cast<uint8>(RevealedCount);
+		AllRevealedFlags[Tile] = RevealedCount == TileEnd - GetTileStart(Tile);
+		ContainsMineFlags[Tile] = bContainsMine;
+	}
+}
+
+void FMinesweeperTileSummaries::Reset()
+{
+	CellCount = 0;
+	RevealedCounts = {};
+	AllRevealedFlags = {};
+	ContainsMineFlags = {};
+}
+
+void FMinesweeperTileSummaries::OnCellStateChanged(int32 Idx, ECellState PreviousState, ECellState NewState)
+{
+	const bool bWasHidden = PreviousState == ECellState::Hidden || PreviousState == ECellState::Flagged;
+	const bool bIsHidden = NewState == ECellState::Hidden || NewState == ECellState::Flagged;
+	if (bWasHidden == bIsHidden)
+	{
+		return;
+	}
+
+	const int32 Tile = Idx >> TILE_SHIFT;
+	RevealedCounts[Tile] += bWasHidden ? 1 : -1;
+	AllRevealedFlags[Tile] = RevealedCounts[Tile] == GetTileEnd(Tile) - GetTileStart(Tile);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperGame.h"
+#include "MinesweeperGameArena.h"
+
+/**
+ * Summary flags of tiles of TILE_CELL_COUNT consecutive cell indices, letting board-wide scans skip whole tiles.
+ * Tiles follow storage order rather than board geometry: under the Morton layout a tile is a 4x4x4 brick,
+ * under the tiled layout it matches an 8x8 square only while every square before it is whole. Cropped
+ * squares along the right and bottom edges hold fewer than 64 cells and shift the tiles after them,
+ * so a tile may span parts of two neighboring squares. Kept up to date cell by cell as cells change state.
+ */
+class FMinesweeperTileSummaries
+{
+public:
+	static constexpr int32 TILE_SHIFT = 6;
+	static constexpr int32 TILE_CELL_COUNT = 1 << TILE_SHIFT;
+
+	/** Summarizes a board whose mines are final, into buffers from the arena of the current game */
+	void Build(const TArray<FMineCell>& Cells, FMinesweeperGameArena& Arena);
+
+	void Reset();
+
+	/** Keeps the summary of the cell's tile in sync with a state change of the cell */
+	void OnCellStateChanged(int32 Idx, ECellState PreviousState, ECellState NewState);
+
+	FORCEINLINE int32 Num() const
+	{
+		return RevealedCounts.Num();
+	}
+
+	/** First cell of given tile */
+	FORCEINLINE int32 GetTileStart(int32 Tile) const
+	{
+		return Tile << TILE_SHIFT;
+	}
+
+	/** One past the last cell of given tile */
+	FORCEINLINE int32 GetTileEnd(int32 Tile) const
+	{
+		return FMath::Min((Tile + 1) << TILE_SHIFT, CellCount);
+	}
+
+	/** Whether every cell of given tile is revealed or exploded, a flagged cell still counts as unrevealed */
+	FORCEINLINE bool IsAllRevealed(int32 Tile) const
+	{
+		return AllRevealedFlags[Tile];
+	}
+
+	FORCEINLINE bool ContainsMine(int32 Tile) const
+	{
+		return ContainsMineFlags[Tile];
+	}
+
+private:
+	int32 CellCount = 0;
+
+	/** Cells of every tile that are revealed or exploded, from which AllRevealedFlags follow */
+	TArrayView<uint8> RevealedCounts;
+	TArrayView<bool>  AllRevealedFlags;
+	TArrayView<bool>  ContainsMineFlags;
+};
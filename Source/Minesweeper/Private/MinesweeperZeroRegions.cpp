@@ -0,0 +1,125 @@
+#include "MinesweeperZeroRegions.h"
+#include "MinesweeperGrid.h"
+
+using namespace MinesweeperGrid;
+
+namespace
+{
+	FORCEINLINE bool IsZeroCell(const FMineCell& Cell)
+	{
+		return !Cell.IsMine() && Cell.NeighborMineCount == 0;
+	}
+
+	/** Distinct regions a cell belongs to, either its own region or those of its zero neighbors */
+	template <typename TTopology, typename FuncType>
+	void ForEachOwningRegion(
+		TArrayView<const int32> RegionIds,
+		const TTopology& Topology,
+		const typename TTopology::FPosition& Pos,
+		int32 Idx,
+		FuncType&& Func)
+	{
+		if (RegionIds[Idx] != INDEX_NONE)
+		{
+			Func(RegionIds[Idx]);
+			return;
+		}
+
+		TArray<int32, TInlineAllocator<TTopology::MAX_NEIGHBOR_COUNT>> Regions;
+		Topology.ForEachNeighborIndex(Pos, [&](int32 NeighborIdx)
+		{
+			const int32 RegionId = RegionIds[NeighborIdx];
+			if (RegionId != INDEX_NONE && !Regions.Contains(RegionId))
+			{
+				Regions.Add(RegionId);
+				Func(RegionId);
+			}
+		});
+	}
+}
+
+template <typename TTopology>
+void FMinesweeperZeroRegions::Build(const TArray<FMineCell>& Cells, const TTopology& Topology, FMinesweeperGameArena& Arena)
+{
+	using FPosition = typename TTopology::FPosition;
+
+	const int32 CellCount = Cells.Num();
+
+	// Union-find parents, only used while labeling
+	TArrayView<int32> Parents = Arena.Allocate<int32>(CellCount);
+	for (int32 Idx = 0; Idx < CellCount; ++Idx)
+	{
+		Parents[Idx] = Idx;
+	}
+
+	// First pass, union every zero cell with its zero neighbors
+	Topology.ForEachCell([&](int32 Idx, const FPosition& Pos)
+	{
+		if (!IsZeroCell(Cells[Idx]))
+		{
+			return;
+		}
+
+		Topology.ForEachNeighborIndex(Pos, [&](int32 NeighborIdx)
+		{
+			if (NeighborIdx < Idx && IsZeroCell(Cells[NeighborIdx]))
+			{
+				Parents[FindRoot(Parents, Idx)] = FindRoot(Parents, NeighborIdx);
+			}
+		});
+	});
+
+	// Second pass, turn roots into compact region ids
+	int32 RegionCount = 0;
+	RegionIds = Arena.AllocateInit<int32>(CellCount, INDEX_NONE);
+	for (int32 Idx = 0; Idx < CellCount; ++Idx)
+	{
+		if (IsZeroCell(Cells[Idx]))
+		{
+			const int32 Root = FindRoot(Parents, Idx);
+			if (RegionIds[Root] == INDEX_NONE)
+			{
+				RegionIds[Root] = RegionCount++;
+			}
+			RegionIds[Idx] = RegionIds[Root];
+		}
+	}
+
+	// Count cells per region including numbered borders, then fill them in ascending order
+	RegionOffsets = Arena.AllocateZeroed<int32>(RegionCount + 1);
+	Topology.ForEachCell([&](int32 Idx, const FPosition& Pos)
+	{
+		ForEachOwningRegion(RegionIds, Topology, Pos, Idx, [this](int32 RegionId)
+		{
+			++RegionOffsets[RegionId + 1];
+		});
+	});
+
+	for (int32 RegionId = 0; RegionId < RegionCount; ++RegionId)
+	{
+		RegionOffsets[RegionId + 1] += RegionOffsets[RegionId];
+	}
+
+	TArrayView<int32> FillOffsets = Arena.Allocate<int32>(RegionCount + 1);
+	FMemory::Memcpy(FillOffsets.GetData(), RegionOffsets.GetData(), FillOffsets.NumBytes());
+	RegionCells = Arena.Allocate<int32>(RegionOffsets.Last());
+
+	Topology.ForEachCell([&](int32 Idx, const FPosition& Pos)
+	{
+		ForEachOwningRegion(RegionIds, Topology, Pos, Idx, [&](int32 RegionId)
+		{
+			RegionCells[FillOffsets[RegionId]++] = Idx;
+		});
+	});
+}
+
+#define INSTANTIATE_BUILD(TTopology) template void FMinesweeperZeroRegions::Build(const TArray<FMineCell>&, const TTopology&, FMinesweeperGameArena&);
+MINESWEEPER_FOR_EACH_TOPOLOGY(INSTANTIATE_BUILD)
+#undef INSTANTIATE_BUILD
+
+void FMinesweeperZeroRegions::Reset()
+{
+	RegionIds = {};
+	RegionOffsets = {};
+	RegionCells = {};
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperGame.h"
+#include "MinesweeperGameArena.h"
+
+/**
+ * Connected regions of cells without neighboring mines, labeled once per board.
+ * Each region also lists its numbered border, so that it holds exactly the cells a
+ * click on any of its cells reveals, in ascending index order.
+ * Buffers come from the arena of the current game.
+ */
+class FMinesweeperZeroRegions
+{
+public:
+	/** Labels regions of a board whose mines and neighbor mine counts are final */
+	template <typename TTopology>
+	void Build(const TArray<FMineCell>& Cells, const TTopology& Topology, FMinesweeperGameArena& Arena);
+
+	void Reset();
+
+	/** Region of a cell without neighboring mines, INDEX_NONE for any other cell */
+	FORCEINLINE int32 GetRegionId(int32 Idx) const
+	{
+		return RegionIds[Idx];
+	}
+
+	/** Every cell revealed by clicking into given region */
+	FORCEINLINE TArrayView<const int32> GetRegionCells(int32 RegionId) const
+	{
+		const int32 Start = RegionOffsets[RegionId];
+		return TArrayView<const int32>{RegionCells.GetData() + Start, RegionOffsets[RegionId + 1] - Start};
+	}
+
+	FORCEINLINE int32 Num() const
+	{
+		return FMath::Max(RegionOffsets.Num() - 1, 0);
+	}
+
+private:
+	TArrayView<int32> RegionIds;
+
+	/** Cells of region R are RegionCells[RegionOffsets[R]] up to RegionCells[RegionOffsets[R + 1]] */
+	TArrayView<int32> RegionOffsets;
+	TArrayView<int32> RegionCells;
+};
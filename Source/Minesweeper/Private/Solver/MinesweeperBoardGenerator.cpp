@@ -0,0 +1,353 @@
+#include "MinesweeperBoardGenerator.h"
+#include "MinesweeperGameArena.h"
+#include "MinesweeperGrid.h"
+#include "MinesweeperSolver.h"
+#include "Async/ParallelFor.h"
+#include <atomic>
+
+using namespace MinesweeperGrid;
+
+namespace
+{
+	/** Total candidate boards tried across all workers before giving up */
+	constexpr int32 MAX_NO_GUESS_ATTEMPTS = 4096;
+
+	/** Local repairs applied to one candidate before discarding it */
+	constexpr int32 MAX_REPAIRS_PER_ATTEMPT = 64;
+
+	/** Random cells tried as the destination of a repair before discarding the candidate */
+	constexpr int32 MAX_INTERIOR_SAMPLES = 64;
+
+	/** Seeds sampled for a board within the target 3BV range before settling for the closest one */
+	constexpr int32 MAX_TARGET_THREE_BV_ATTEMPTS = 4096;
+
+	void RandomPopulateMines(TArray<FMineCell>& Cells, int32 MineCount, FRandomStream& Stream)
+	{
+		check(MineCount > 0 && MineCount <= Cells.Num());
+
+		for (int32 Idx = 0; Idx < MineCount; ++Idx)
+		{
+			Cells[Idx].CellType = ECellType::Mine;
+		}
+
+		// Shuffling via placing random element at the top of the array
+		for (int32 Idx = 0; Idx < Cells.Num(); ++Idx)
+		{
+			const int32 RandomIdx = Stream.RandRange(Idx, Cells.Num() - 1);
+			Cells.Swap(Idx, RandomIdx);
+		}
+	}
+
+	/** Places mines anywhere except cell StartIdx and its neighbors, so that the first click opens a region */
+	template <typename TTopology>
+	void PopulateMinesAroundOpening(
+		TArrayView<FMineCell> Cells,
+		const TTopology& Topology,
+		int32 MineCount,
+		int32 StartIdx,
+		FRandomStream& Stream,
+		TArrayView<int32> Candidates)
+	{
+		FMemory::Memzero(Cells.GetData(), Cells.Num() * sizeof(FMineCell));
+
+		TArray<int32, TInlineAllocator<TTopology::MAX_NEIGHBOR_COUNT + 1>> Opening;
+		Opening.Add(StartIdx);
+		Topology.ForEachNeighborIndex(Topology.GetCellPosition(StartIdx), [&Opening](int32 NeighborIdx)
+		{
+			Opening.Add(NeighborIdx);
+		});
+
+		int32 CandidateCount = 0;
+		for (int32 Idx = 0; Idx < Cells.Num(); ++Idx)
+		{
+			if (!Opening.Contains(Idx))
+			{
+				Candidates[CandidateCount++] = Idx;
+			}
+		}
+
+		check(MineCount <= CandidateCount);
+
+		// Partial Fisher-Yates shuffle, only the first MineCount candidates matter
+		for (int32 Idx = 0; Idx < MineCount; ++Idx)
+		{
+			const int32 RandomIdx = Stream.RandRange(Idx, CandidateCount - 1);
+			Swap(Candidates[Idx], Candidates[RandomIdx]);
+			Cells[Candidates[Idx]].CellType = ECellType::Mine;
+		}
+
+		CalculateNeighborMineCounts(Cells, Topology);
+	}
+
+	template <typename TTopology>
+	void MoveMine(TArrayView<FMineCell> Cells, const TTopology& Topology, int32 FromIdx, int32 ToIdx)
+	{
+		Cells[FromIdx].CellType = ECellType::Empty;
+		Topology.ForEachNeighborIndex(Topology.GetCellPosition(FromIdx), [&Cells](int32 NeighborIdx)
+		{
+			--Cells[NeighborIdx].NeighborMineCount;
+		});
+
+		Cells[ToIdx].CellType = ECellType::Mine;
+		Topology.ForEachNeighborIndex(Topology.GetCellPosition(ToIdx), [&Cells](int32 NeighborIdx)
+		{
+			++Cells[NeighborIdx].NeighborMineCount;
+		});
+	}
+
+	/**
+	 * Resolves the spot where the solver got stuck by moving one undetermined frontier mine
+	 * into the undetermined interior, which keeps mine count intact and only touches its neighbors.
+	 * Frontier mines come from the numbers the solver got stuck on, and the destination is sampled at random,
+	 * so a repair costs time proportional to the frontier rather than to the board.
+	 * Returns false if there is nothing left to move, or no interior cell turned up among the samples.
+	 */
+	template <typename TTopology>
+	bool RepairStuckFrontier(
+		TArrayView<FMineCell> Cells,
+		const TTopology& Topology,
+		const TMinesweeperSolver<TTopology>& Solver,
+		FRandomStream& Stream,
+		TArrayView<int32> FrontierMines)
+	{
+		int32 FrontierMineCount = 0;
+		Solver.ForEachFrontierCell([&](int32 Idx)
+		{
+			if (Cells[Idx].IsMine() && !FrontierMines.Slice(0, FrontierMineCount).Contains(Idx))
+			{
+				FrontierMines[FrontierMineCount++] = Idx;
+			}
+		});
+
+		if (FrontierMineCount == 0)
+		{
+			return false;
+		}
+
+		int32 ToIdx = INDEX_NONE;
+		for (int32 Sample = 0; Sample < MAX_INTERIOR_SAMPLES && ToIdx == INDEX_NONE; ++Sample)
+		{
+			const int32 Idx = Stream.RandHelper(Cells.Num());
+			if (!Solver.IsUndetermined(Idx) || Cells[Idx].IsMine())
+			{
+				continue;
+			}
+
+			bool bIsFrontier = false;
+			Topology.ForEachNeighborIndex(Topology.GetCellPosition(Idx), [&](int32 NeighborIdx)
+			{
+				bIsFrontier |= Solver.IsRevealed(NeighborIdx);
+			});
+
+			if (!bIsFrontier)
+			{
+				ToIdx = Idx;
+			}
+		}
+
+		if (ToIdx == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const int32 FromIdx = FrontierMines[Stream.RandHelper(FrontierMineCount)];
+		MoveMine(Cells, Topology, FromIdx, ToIdx);
+
+		return true;
+	}
+
+	/** Seed of given attempt, the first one being the base seed itself so that a board within range stays as it was */
+	int32 GetAttemptSeed(int32 BaseSeed, int32 Attempt)
+	{
+		return Attempt == 0 ? BaseSeed : static_cast<int32>(HashCombine(GetTypeHash(BaseSeed), GetTypeHash(Attempt)));
+	}
+
+	void PopulateRandomBoard(TArray<FMineCell>& Cells, int32 MineCount, int32 Seed)
+	{
+		FRandomStream Stream;
+		Stream.Initialize(Seed);
+
+		FMemory::Memzero(Cells.GetData(), Cells.Num() * sizeof(FMineCell));
+		RandomPopulateMines(Cells, MineCount, Stream);
+	}
+
+	template <typename TTopology>
+	bool GenerateTargetThreeBVBoard(
+		TArray<FMineCell>& Cells,
+		const FMinesweeperGameConfig& Config,
+		int32 BaseSeed,
+		const TTopology& Topology,
+		FMinesweeperGameArena& Arena)
+	{
+		const FInt32Interval& Target = Config.TargetThreeBV.GetValue();
+		const double StartTime = FPlatformTime::Seconds();
+
+		const TArrayView<int32> Parents = Arena.Allocate<int32>(Cells.Num());
+
+		int32 ClosestAttempt = 0;
+		int32 ClosestDistance = MAX_int32;
+		int32 ThreeBV = 0;
+
+		for (int32 Attempt = 0; Attempt < MAX_TARGET_THREE_BV_ATTEMPTS && ClosestDistance > 0; ++Attempt)
+		{
+			PopulateRandomBoard(Cells, Config.MineCount, GetAttemptSeed(BaseSeed, Attempt));
+			CalculateNeighborMineCounts(Cells, Topology);
+			ThreeBV = CalculateBoardMetrics(Cells, Topology, Parents).ThreeBV;
+
+			const int32 Distance = FMath::Max3(Target.Min - ThreeBV, ThreeBV - Target.Max, 0);
+			if (Distance < ClosestDistance)
+			{
+				ClosestAttempt = Attempt;
+				ClosestDistance = Distance;
+			}
+		}
+
+		if (ClosestDistance == 0)
+		{
+			UE_LOG(LogTemp, Verbose, TEXT("Board of 3BV %d found at attempt %d in %.2f ms."),
+				ThreeBV, ClosestAttempt, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+			return true;
+		}
+
+		UE_LOG(LogTemp, Warning, TEXT("Board of 3BV within [%d, %d] not found within %d attempts, falling back to the closest one."),
+			Target.Min, Target.Max, MAX_TARGET_THREE_BV_ATTEMPTS);
+
+		// Regenerating the closest board from its seed rather than keeping a copy of it around
+		PopulateRandomBoard(Cells, Config.MineCount, GetAttemptSeed(BaseSeed, ClosestAttempt));
+		CalculateNeighborMineCounts(Cells, Topology);
+		return false;
+	}
+
+	template <typename TTopology>
+	bool GenerateNoGuessBoard(
+		TArray<FMineCell>& Cells,
+		const FMinesweeperGameConfig& Config,
+		int32 StartIdx,
+		const TTopology& Topology,
+		FMinesweeperGameArena& Arena)
+	{
+		const int32 CellCount = Topology.GetCellCount();
+		const int32 MineCount = Config.MineCount;
+		const int32 BaseSeed = Config.RandomSeed ? *Config.RandomSeed : FMath::Rand();
+		const int32 WorkerCount = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads() + 1);
+		const double StartTime = FPlatformTime::Seconds();
+
+		check(Cells.Num() == CellCount);
+
+		// Every worker grabs the next attempt index, the lowest attempt that solves wins.
+		// Attempts beyond the current winner get cancelled, so the result only depends on the seed.
+		std::atomic<int32> NextAttempt{0};
+		std::atomic<int32> WinningAttempt{MAX_NO_GUESS_ATTEMPTS};
+		FCriticalSection ResultLock;
+		FCriticalSection ArenaLock;
+
+		ParallelFor(WorkerCount, [&](int32)
+		{
+			// Every worker takes its slice of the arena once, so attempts reuse the same buffers
+			// and games of the same size reuse the memory of the previous one
+			FScopeLock ArenaScopeLock{&ArenaLock};
+			const TArrayView<FMineCell> Candidate = Arena.Allocate<FMineCell>(CellCount);
+			const TArrayView<int32> Scratch = Arena.Allocate<int32>(CellCount);
+			const TArrayView<int32> FrontierMines = Arena.Allocate<int32>(CellCount);
+			TMinesweeperSolver<TTopology> Solver{Topology, Arena};
+			ArenaScopeLock.Unlock();
+
+			for (;;)
+			{
+				const int32 Attempt = NextAttempt.fetch_add(1);
+				if (Attempt >= WinningAttempt.load())
+				{
+					break;
+				}
+
+				FRandomStream Stream;
+				Stream.Initialize(static_cast<int32>(HashCombine(GetTypeHash(BaseSeed), GetTypeHash(Attempt))));
+				PopulateMinesAroundOpening(Candidate, Topology, MineCount, StartIdx, Stream, Scratch);
+
+				bool bIsSolved = Solver.Solve(Candidate, MineCount, StartIdx);
+				for (int32 Repair = 0; !bIsSolved && Repair < MAX_REPAIRS_PER_ATTEMPT; ++Repair)
+				{
+					const bool bIsCancelled = Attempt >= WinningAttempt.load();
+					if (bIsCancelled || !RepairStuckFrontier(Candidate, Topology, Solver, Stream, FrontierMines))
+					{
+						break;
+					}
+					bIsSolved = Solver.Solve(Candidate, MineCount, StartIdx);
+				}
+
+				if (bIsSolved)
+				{
+					FScopeLock Lock{&ResultLock};
+					if (Attempt < WinningAttempt.load())
+					{
+						WinningAttempt.store(Attempt);
+						FMemory::Memcpy(Cells.GetData(), Candidate.GetData(), CellCount * sizeof(FMineCell));
+					}
+					break;
+				}
+			}
+		});
+
+		const int32 Winner = WinningAttempt.load();
+		const bool bHasFoundBoard = Winner < MAX_NO_GUESS_ATTEMPTS;
+
+		if (bHasFoundBoard)
+		{
+			UE_LOG(LogTemp, Verbose, TEXT("No-guess board found at attempt %d in %.2f ms."),
+				Winner, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("No-guess board not found within %d attempts, falling back to a safe opening."),
+				MAX_NO_GUESS_ATTEMPTS);
+
+			FRandomStream Stream;
+			Stream.Initialize(BaseSeed);
+			PopulateMinesAroundOpening(Cells, Topology, MineCount, StartIdx, Stream, Arena.Allocate<int32>(CellCount));
+		}
+
+		return bHasFoundBoard;
+	}
+}
+
+bool FMinesweeperBoardGenerator::GenerateRandom(
+	TArray<FMineCell>& Cells,
+	const FMinesweeperGameConfig& Config,
+	FMinesweeperGameArena& Arena)
+{
+	const int32 BaseSeed = Config.RandomSeed ? *Config.RandomSeed : FMath::Rand();
+
+	if (Config.TargetThreeBV)
+	{
+		return DispatchTopology(Config, [&](const auto& Topology)
+		{
+			return GenerateTargetThreeBVBoard(Cells, Config, BaseSeed, Topology, Arena);
+		});
+	}
+
+	FRandomStream Stream;
+	Stream.Initialize(BaseSeed);
+
+	RandomPopulateMines(Cells, Config.MineCount, Stream);
+	if (!Config.bLazyNeighborCounts)
+	{
+		DispatchTopology(Config, [&Cells](const auto& Topology)
+		{
+			CalculateNeighborMineCounts(Cells, Topology);
+		});
+	}
+
+	return true;
+}
+
+bool FMinesweeperBoardGenerator::GenerateNoGuess(
+	TArray<FMineCell>& Cells,
+	const FMinesweeperGameConfig& Config,
+	int32 StartIdx,
+	FMinesweeperGameArena& Arena)
+{
+	return DispatchTopology(Config, [&](const auto& Topology)
+	{
+		return GenerateNoGuessBoard(Cells, Config, StartIdx, Topology, Arena);
+	});
+}
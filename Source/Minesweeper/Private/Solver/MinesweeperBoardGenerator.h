@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperGame.h"
+
+/**
+ * Places mines on a board according to the game config. Designed for:
+ * 1. Classic random placement done at game start, optionally resampled until its 3BV falls within a target range.
+ * 2. No-guess placement done upon first click, where candidate boards are
+ *    verified by FMinesweeperSolver speculatively on several worker threads.
+ */
+class FMinesweeperBoardGenerator
+{
+public:
+	/**
+	 * Places mines uniformly at random and calculates neighbor mine counts, unless the config counts them lazily.
+	 * With a target 3BV range, returns false if no board within range was found within the attempt budget,
+	 * in which case Cells holds the board closest to it. Scratch for measuring candidates comes from the arena of the game.
+	 */
+	static bool GenerateRandom(TArray<FMineCell>& Cells, const FMinesweeperGameConfig& Config, class FMinesweeperGameArena& Arena);
+
+	/**
+	 * Places mines so that the board can be solved by logic alone when first clicking cell StartIdx.
+	 * Returns false if no solvable board was found within the attempt budget, in which case
+	 * Cells still holds a valid board with a safe opening around StartIdx. Candidate boards and solvers
+	 * of the workers come from the arena of the game, the winner gets copied into Cells.
+	 */
+	static bool GenerateNoGuess(TArray<FMineCell>& Cells, const FMinesweeperGameConfig& Config, int32 StartIdx, class FMinesweeperGameArena& Arena);
+};
@@ -0,0 +1,704 @@
+#include "MinesweeperProbabilityAnalyzer.h"
+#include "MinesweeperGrid.h"
+#include "Async/Async.h"
+
+using namespace MinesweeperGrid;
+
+namespace
+{
+	/** Components larger than this get estimated instead of enumerated */
+	constexpr int32 MAX_EXACT_COMPONENT_SIZE = 48;
+
+	/** Search nodes visited in one component before falling back to estimation */
+	constexpr int64 MAX_SEARCH_NODES = 1 << 21;
+
+	/** Backtracking enumeration of every mine assignment consistent with a component's constraints */
+	struct FComponentEnumerator
+	{
+		TArray<TArray<int32, TInlineAllocator<8>>> VariableConstraints;
+		TArray<int32> RemainingMines;
+		TArray<int32> UnassignedCounts;
+		TArray<uint8> Assignment;
+
+		double* MineCountWeights;
+		double* CellMineWeights;
+		int32   Stride;
+		int64   NodeCount = 0;
+		bool    bIsAborted = false;
+
+		bool Assign(int32 Variable, uint8 Value)
+		{
+			bool bIsConsistent = true;
+			Assignment[Variable] = Value;
+
+			for (const int32 Constraint : VariableConstraints[Variable])
+			{
+				RemainingMines[Constraint] -= Value;
+				UnassignedCounts[Constraint] -= 1;
+				bIsConsistent &= RemainingMines[Constraint] >= 0 && RemainingMines[Constraint] <= UnassignedCounts[Constraint];
+			}
+
+			return bIsConsistent;
+		}
+
+		void Unassign(int32 Variable, uint8 Value)
+		{
+			for (const int32 Constraint : VariableConstraints[Variable])
+			{
+				RemainingMines[Constraint] += Value;
+				UnassignedCounts[Constraint] += 1;
+			}
+		}
+
+		void Enumerate(int32 Variable, int32 MineCount)
+		{
+			if (bIsAborted || ++NodeCount > MAX_SEARCH_NODES)
+			{
+				bIsAborted = true;
+				return;
+			}
+
+			if (Variable == Assignment.Num())
+			{
+				MineCountWeights[MineCount] += 1.0;
+				for (int32 Idx = 0; Idx < Assignment.Num(); ++Idx)
+				{
+					CellMineWeights[Idx * Stride + MineCount] += Assignment[Idx];
+				}
+				return;
+			}
+
+			for (uint8 Value = 0; Value <= 1; ++Value)
+			{
+				if (Assign(Variable, Value))
+				{
+					Enumerate(Variable + 1, MineCount + Value);
+				}
+				Unassign(Variable, Value);
+			}
+		}
+	};
+
+	/** Out holds A.Num() + B.Num() - 1 weights */
+	void Convolve(TConstArrayView<double> A, TConstArrayView<double> B, TArrayView<double> Out)
+	{
+		check(Out.Num() == A.Num() + B.Num() - 1);
+		FMemory::Memzero(Out.GetData(), Out.Num() * sizeof(double));
+
+		for (int32 IdxA = 0; IdxA < A.Num(); ++IdxA)
+		{
+			for (int32 IdxB = 0; IdxB < B.Num(); ++IdxB)
+			{
+				Out[IdxA + IdxB] += A[IdxA] * B[IdxB];
+			}
+		}
+	}
+}
+
+FMinesweeperProbabilityAnalyzer::FMinesweeperProbabilityAnalyzer() :
+	bHasPendingSubmission{false},
+	bHasPendingBoard{false},
+	PendingConfig{FMinesweeperGameConfig::MakeDefaultConfig()},
+	PendingRevision{0},
+	LatestRevision{0},
+	bIsWorkerRunning{false},
+	WorkerSnapshot{0, FMinesweeperGameConfig::MakeDefaultConfig(), {}},
+	bIsFrontierIndexStale{true},
+	HiddenCellCount{0}
+{
+}
+
+FMinesweeperProbabilityAnalyzer::~FMinesweeperProbabilityAnalyzer()
+{
+	{
+		FScopeLock ScopeLock{&Lock};
+		bHasPendingSubmission = false;
+	}
+
+	// Worker still references this analyzer until it finishes the snapshot in flight
+	if (WorkerFuture.IsValid())
+	{
+		WorkerFuture.Wait();
+	}
+}
+
+uint32 FMinesweeperProbabilityAnalyzer::SubmitBoard(const FMinesweeperGameConfig& Config, TArray<int8>&& Knowledge)
+{
+	FScopeLock ScopeLock{&Lock};
+
+	// Changes still pending were made to the board this one replaces
+	bHasPendingBoard = true;
+	PendingConfig = Config;
+	PendingKnowledge = MoveTemp(Knowledge);
+	PendingChanges.Reset();
+	StartWorker();
+
+	return LatestRevision;
+}
+
+uint32 FMinesweeperProbabilityAnalyzer::SubmitChanges(TConstArrayView<int32> ChangedCells, TFunctionRef<int8(int32 Idx)> GetKnowledge)
+{
+	FScopeLock ScopeLock{&Lock};
+
+	for (const int32 Idx : ChangedCells)
+	{
+		PendingChanges.Add(FKnowledgeChange{Idx, GetKnowledge(Idx)});
+	}
+	StartWorker();
+
+	return LatestRevision;
+}
+
+void FMinesweeperProbabilityAnalyzer::StartWorker()
+{
+	bHasPendingSubmission = true;
+	PendingRevision = ++LatestRevision;
+
+	if (!bIsWorkerRunning)
+	{
+		bIsWorkerRunning = true;
+		WorkerFuture = Async(EAsyncExecution::ThreadPool, [this]()
+		{
+			RunWorker();
+		});
+	}
+}
+
+FMinesweeperProbabilityAnalyzer::FResultPtr FMinesweeperProbabilityAnalyzer::GetLatestResult() const
+{
+	FScopeLock ScopeLock{&Lock};
+	return LatestResult;
+}
+
+void FMinesweeperProbabilityAnalyzer::RunWorker()
+{
+	for (;;)
+	{
+		{
+			FScopeLock ScopeLock{&Lock};
+			if (!bHasPendingSubmission)
+			{
+				bIsWorkerRunning = false;
+				return;
+			}
+			bHasPendingSubmission = false;
+
+			// Buffers trade places rather than getting copied, the replaced board is moved out again by the next one
+			if (bHasPendingBoard)
+			{
+				bHasPendingBoard = false;
+				WorkerSnapshot.Config = PendingConfig;
+				Swap(WorkerSnapshot.Knowledge, PendingKnowledge);
+				bIsFrontierIndexStale = true;
+			}
+			Swap(WorkerChanges, PendingChanges);
+			PendingChanges.Reset();
+			WorkerSnapshot.Revision = PendingRevision;
+		}
+
+		const TSharedRef<FMinesweeperProbabilityResult, ESPMode::ThreadSafe> Result =
+			MakeShared<FMinesweeperProbabilityResult, ESPMode::ThreadSafe>();
+		Analyze(*Result);
+
+		FScopeLock ScopeLock{&Lock};
+		LatestResult = Result;
+	}
+}
+
+void FMinesweeperProbabilityAnalyzer::Analyze(FMinesweeperProbabilityResult& OutResult)
+{
+	const FSnapshot& Snapshot = WorkerSnapshot;
+	const TArray<int8>& Knowledge = Snapshot.Knowledge;
+	const int32 CellCount = Knowledge.Num();
+
+	TArray<FComponent> Components;
+	TArray<FComponentSolution> Solutions;
+
+	DispatchTopology(Snapshot.Config, [&](const auto& Topology)
+	{
+		// Whole board gets indexed once, after that only the neighbors of changed cells are touched
+		if (bIsFrontierIndexStale)
+		{
+			for (const FKnowledgeChange& Change : WorkerChanges)
+			{
+				WorkerSnapshot.Knowledge[Change.Idx] = Change.Knowledge;
+			}
+			RebuildFrontierIndex(Topology);
+			bIsFrontierIndexStale = false;
+		}
+		else
+		{
+			ApplyChanges(Topology);
+		}
+
+		FindComponents(Snapshot, Topology, Components);
+
+		Solutions.SetNum(Components.Num());
+		for (int32 Idx = 0; Idx < Components.Num(); ++Idx)
+		{
+			SolveComponent(Snapshot, Topology, Components[Idx], Solutions[Idx]);
+		}
+	});
+
+	// Components that vanished or changed since last analysis drop out of the cache
+	SolutionCache = MoveTemp(UsedSolutions);
+	UsedSolutions.Reset();
+
+	if (LogFactorials.Num() != CellCount + 1)
+	{
+		RebuildLogFactorials(CellCount);
+	}
+
+	// Distribution of the mines on the components before each one, back to back, the last being the whole frontier
+	const int32 ComponentCount = Components.Num();
+	TArray<double> PrefixWeights{1.0};
+	TArray<int32> PrefixOffsets;
+	PrefixOffsets.SetNumUninitialized(ComponentCount + 1);
+	PrefixOffsets[0] = 0;
+
+	for (int32 ComponentIdx = 0; ComponentIdx < ComponentCount; ++ComponentIdx)
+	{
+		const int32 PrefixNum = PrefixWeights.Num() - PrefixOffsets[ComponentIdx];
+		const int32 NextNum = PrefixNum + Solutions[ComponentIdx].MineCountWeights.Num() - 1;
+
+		PrefixOffsets[ComponentIdx + 1] = PrefixWeights.Num();
+		PrefixWeights.AddUninitialized(NextNum);
+
+		const TConstArrayView<double> Prefix{PrefixWeights.GetData() + PrefixOffsets[ComponentIdx], PrefixNum};
+		const TArrayView<double> NextPrefix{PrefixWeights.GetData() + PrefixOffsets[ComponentIdx + 1], NextNum};
+		Convolve(Prefix, Solutions[ComponentIdx].MineCountWeights, NextPrefix);
+	}
+
+	const TConstArrayView<double> FrontierWeights{
+		PrefixWeights.GetData() + PrefixOffsets[ComponentCount], PrefixWeights.Num() - PrefixOffsets[ComponentCount]};
+
+	// Every frontier mine count leaves C(InteriorCount, MineCount - FrontierMineCount) interior layouts
+	const int32 InteriorCount = HiddenCellCount - VariableCells.Cells.Num();
+	const int32 MineCount = Snapshot.Config.MineCount;
+
+	TArray<double> LayoutWeights;
+	LayoutWeights.Init(0.0, FrontierWeights.Num());
+	double MaxLogWeight = TNumericLimits<double>::Lowest();
+	for (int32 FrontierMines = 0; FrontierMines < FrontierWeights.Num(); ++FrontierMines)
+	{
+		const int32 InteriorMines = MineCount - FrontierMines;
+		if (InteriorMines >= 0 && InteriorMines <= InteriorCount)
+		{
+			const double LogWeight = LogFactorials[InteriorCount] - LogFactorials[InteriorMines] - LogFactorials[InteriorCount - InteriorMines];
+			LayoutWeights[FrontierMines] = LogWeight;
+			MaxLogWeight = FMath::Max(MaxLogWeight, LogWeight);
+		}
+		else
+		{
+			LayoutWeights[FrontierMines] = TNumericLimits<double>::Lowest();
+		}
+	}
+
+	for (double& Weight : LayoutWeights)
+	{
+		Weight = Weight == TNumericLimits<double>::Lowest() ? 0.0 : FMath::Exp(Weight - MaxLogWeight);
+	}
+
+	double TotalWeight = 0.0;
+	double InteriorMineWeight = 0.0;
+	for (int32 FrontierMines = 0; FrontierMines < FrontierWeights.Num(); ++FrontierMines)
+	{
+		const double Weight = FrontierWeights[FrontierMines] * LayoutWeights[FrontierMines];
+		TotalWeight += Weight;
+		InteriorMineWeight += Weight * (MineCount - FrontierMines);
+	}
+
+	OutResult.Revision = Snapshot.Revision;
+	OutResult.MineProbabilities.Init(-1.0F, CellCount);
+
+	if (TotalWeight <= 0.0)
+	{
+		return;
+	}
+
+	// Frontier cells get theirs below, so every hidden cell can start out with that of the interior
+	if (InteriorCount > 0)
+	{
+		const float InteriorProbability = static_cast<float>(InteriorMineWeight / (TotalWeight * InteriorCount));
+		for (int32 Idx = 0; Idx < CellCount; ++Idx)
+		{
+			if (Knowledge[Idx] == HIDDEN_CELL)
+			{
+				OutResult.MineProbabilities[Idx] = InteriorProbability;
+			}
+		}
+	}
+
+	// Layout weights folded with the components after the current one, indexed by the mines of those before it.
+	// Each component then only combines with the prefix before it, rather than convolving all the others
+	TArray<double> SuffixWeights = LayoutWeights;
+	TArray<double> Scratch;
+	TArray<double> CombinedWeights;
+	for (int32 ComponentIdx = ComponentCount - 1; ComponentIdx >= 0; --ComponentIdx)
+	{
+		const TConstArrayView<double> Prefix{
+			PrefixWeights.GetData() + PrefixOffsets[ComponentIdx], PrefixOffsets[ComponentIdx + 1] - PrefixOffsets[ComponentIdx]};
+
+		const FComponentSolution& Solution = Solutions[ComponentIdx];
+		const int32 Stride = Solution.MineCountWeights.Num();
+
+		CombinedWeights.Init(0.0, Stride);
+		for (int32 Mines = 0; Mines < Stride; ++Mines)
+		{
+			for (int32 OtherMines = 0; OtherMines < Prefix.Num(); ++OtherMines)
+			{
+				CombinedWeights[Mines] += Prefix[OtherMines] * SuffixWeights[Mines + OtherMines];
+			}
+		}
+
+		const TArray<int32>& Variables = Components[ComponentIdx].Variables;
+		for (int32 Variable = 0; Variable < Variables.Num(); ++Variable)
+		{
+			double MineWeight = 0.0;
+			if (Solution.PinnedMineCount != INDEX_NONE)
+			{
+				MineWeight = Solution.CellMineWeights[Variable] * CombinedWeights[Solution.PinnedMineCount];
+			}
+			else
+			{
+				for (int32 Mines = 0; Mines < Stride; ++Mines)
+				{
+					MineWeight += Solution.CellMineWeights[Variable * Stride + Mines] * CombinedWeights[Mines];
+				}
+			}
+			OutResult.MineProbabilities[Variables[Variable]] = static_cast<float>(MineWeight / TotalWeight);
+		}
+
+		// Components before this one only ever hold as many mines as the prefix allows
+		Scratch.Init(0.0, Prefix.Num());
+		for (int32 OtherMines = 0; OtherMines < Prefix.Num(); ++OtherMines)
+		{
+			for (int32 Mines = 0; Mines < Stride; ++Mines)
+			{
+				Scratch[OtherMines] += Solution.MineCountWeights[Mines] * SuffixWeights[OtherMines + Mines];
+			}
+		}
+		Swap(SuffixWeights, Scratch);
+	}
+}
+
+void FMinesweeperProbabilityAnalyzer::RebuildLogFactorials(int32 CellCount)
+{
+	LogFactorials.SetNumUninitialized(CellCount + 1);
+	LogFactorials[0] = 0.0;
+	for (int32 Idx = 1; Idx <= CellCount; ++Idx)
+	{
+		LogFactorials[Idx] = LogFactorials[Idx - 1] + FMath::Loge(static_cast<double>(Idx));
+	}
+}
+
+template <typename TTopology>
+void FMinesweeperProbabilityAnalyzer::RebuildFrontierIndex(const TTopology& Topology)
+{
+	const TArray<int8>& Knowledge = WorkerSnapshot.Knowledge;
+	const int32 CellCount = Knowledge.Num();
+
+	HiddenNeighborCounts.Init(0, CellCount);
+	NumberNeighborCounts.Init(0, CellCount);
+	ConstraintCells.Reset(CellCount);
+	VariableCells.Reset(CellCount);
+	HiddenCellCount = 0;
+
+	Topology.ForEachCell([&](int32 Idx, const typename TTopology::FPosition& Pos)
+	{
+		HiddenCellCount += Knowledge[Idx] == HIDDEN_CELL;
+		Topology.ForEachNeighborIndex(Pos, [&](int32 NeighborIdx)
+		{
+			HiddenNeighborCounts[Idx] += static_cast<uint8>(Knowledge[NeighborIdx] == HIDDEN_CELL);
+			NumberNeighborCounts[Idx] += static_cast<uint8>(Knowledge[NeighborIdx] > 0);
+		});
+	});
+
+	for (int32 Idx = 0; Idx < CellCount; ++Idx)
+	{
+		UpdateFrontierIndex(Idx);
+	}
+}
+
+template <typename TTopology>
+void FMinesweeperProbabilityAnalyzer::ApplyChanges(const TTopology& Topology)
+{
+	TArray<int8>& Knowledge = WorkerSnapshot.Knowledge;
+
+	for (const FKnowledgeChange& Change : WorkerChanges)
+	{
+		checkSlow(Knowledge.IsValidIndex(Change.Idx));
+
+		const int8 PreviousKnowledge = Knowledge[Change.Idx];
+		if (PreviousKnowledge == Change.Knowledge)
+		{
+			continue;
+		}
+		Knowledge[Change.Idx] = Change.Knowledge;
+
+		const int32 HiddenDelta = (Change.Knowledge == HIDDEN_CELL) - (PreviousKnowledge == HIDDEN_CELL);
+		const int32 NumberDelta = (Change.Knowledge > 0) - (PreviousKnowledge > 0);
+
+		HiddenCellCount += HiddenDelta;
+		UpdateFrontierIndex(Change.Idx);
+
+		if (HiddenDelta == 0 && NumberDelta == 0)
+		{
+			continue;
+		}
+
+		Topology.ForEachNeighborIndex(Topology.GetCellPosition(Change.Idx), [&](int32 NeighborIdx)
+		{
+			HiddenNeighborCounts[NeighborIdx] = static_cast<uint8>(HiddenNeighborCounts[NeighborIdx] + HiddenDelta);
+			NumberNeighborCounts[NeighborIdx] = static_cast<uint8>(NumberNeighborCounts[NeighborIdx] + NumberDelta);
+			UpdateFrontierIndex(NeighborIdx);
+		});
+	}
+}
+
+void FMinesweeperProbabilityAnalyzer::UpdateFrontierIndex(int32 Idx)
+{
+	const int8 CellKnowledge = WorkerSnapshot.Knowledge[Idx];
+
+	if (CellKnowledge > 0 && HiddenNeighborCounts[Idx] > 0)
+	{
+		ConstraintCells.Add(Idx);
+	}
+	else
+	{
+		ConstraintCells.Remove(Idx);
+	}
+
+	if (CellKnowledge == HIDDEN_CELL && NumberNeighborCounts[Idx] > 0)
+	{
+		VariableCells.Add(Idx);
+	}
+	else
+	{
+		VariableCells.Remove(Idx);
+	}
+}
+
+void FMinesweeperProbabilityAnalyzer::FCellSet::Reset(int32 CellCount)
+{
+	Cells.Reset(CellCount);
+	DenseIndices.Init(INDEX_NONE, CellCount);
+}
+
+void FMinesweeperProbabilityAnalyzer::FCellSet::Add(int32 Idx)
+{
+	if (DenseIndices[Idx] == INDEX_NONE)
+	{
+		DenseIndices[Idx] = Cells.Add(Idx);
+	}
+}
+
+void FMinesweeperProbabilityAnalyzer::FCellSet::Remove(int32 Idx)
+{
+	const int32 DenseIdx = DenseIndices[Idx];
+	if (DenseIdx == INDEX_NONE)
+	{
+		return;
+	}
+
+	const int32 LastIdx = Cells.Pop(false);
+	if (LastIdx != Idx)
+	{
+		Cells[DenseIdx] = LastIdx;
+		DenseIndices[LastIdx] = DenseIdx;
+	}
+	DenseIndices[Idx] = INDEX_NONE;
+}
+
+template <typename TTopology>
+void FMinesweeperProbabilityAnalyzer::FindComponents(
+	const FSnapshot& Snapshot,
+	const TTopology& Topology,
+	TArray<FComponent>& OutComponents)
+{
+	const TArray<int8>& Knowledge = Snapshot.Knowledge;
+
+	// Only variables ever get merged, so theirs are the only parents to reset
+	ComponentParents.SetNumUninitialized(Knowledge.Num());
+	for (const int32 Idx : VariableCells.Cells)
+	{
+		ComponentParents[Idx] = Idx;
+	}
+
+	// Hidden neighbors of the same number belong to the same component
+	TArray<int32> FirstHiddenNeighbors;
+	FirstHiddenNeighbors.SetNumUninitialized(ConstraintCells.Cells.Num());
+	for (int32 ConstraintIdx = 0; ConstraintIdx < ConstraintCells.Cells.Num(); ++ConstraintIdx)
+	{
+		int32 FirstHidden = INDEX_NONE;
+		Topology.ForEachNeighborIndex(Topology.GetCellPosition(ConstraintCells.Cells[ConstraintIdx]), [&](int32 NeighborIdx)
+		{
+			if (Knowledge[NeighborIdx] == HIDDEN_CELL)
+			{
+				if (FirstHidden == INDEX_NONE)
+				{
+					FirstHidden = NeighborIdx;
+				}
+				ComponentParents[FindRoot(ComponentParents, NeighborIdx)] = FindRoot(ComponentParents, FirstHidden);
+			}
+		});
+		FirstHiddenNeighbors[ConstraintIdx] = FirstHidden;
+	}
+
+	TMap<int32, int32> RootToComponent;
+	const auto FindComponent = [&](int32 Idx) -> FComponent&
+	{
+		const int32 Root = FindRoot(ComponentParents, Idx);
+		int32* ComponentIdx = RootToComponent.Find(Root);
+		if (!ComponentIdx)
+		{
+			ComponentIdx = &RootToComponent.Add(Root, OutComponents.AddDefaulted());
+		}
+		return OutComponents[*ComponentIdx];
+	};
+
+	for (const int32 Idx : VariableCells.Cells)
+	{
+		FindComponent(Idx).Variables.Add(Idx);
+	}
+
+	for (int32 ConstraintIdx = 0; ConstraintIdx < ConstraintCells.Cells.Num(); ++ConstraintIdx)
+	{
+		FindComponent(FirstHiddenNeighbors[ConstraintIdx]).Constraints.Add(ConstraintCells.Cells[ConstraintIdx]);
+	}
+
+	// Sets come in order of changes, ascending cell order keeps keys of untouched components stable across analyses
+	for (FComponent& Component : OutComponents)
+	{
+		Component.Variables.Sort();
+		Component.Constraints.Sort();
+	}
+}
+
+template <typename TTopology>
+void FMinesweeperProbabilityAnalyzer::SolveComponent(
+	const FSnapshot& Snapshot,
+	const TTopology& Topology,
+	const FComponent& Component,
+	FComponentSolution& OutSolution)
+{
+	const TArray<int8>& Knowledge = Snapshot.Knowledge;
+	const TArray<int32>& Variables = Component.Variables;
+	const TArray<int32>& Constraints = Component.Constraints;
+
+	TArray<int32> Key;
+	Key.Reserve(Variables.Num() + Constraints.Num() * 2);
+	Key.Append(Variables);
+	for (const int32 Constraint : Constraints)
+	{
+		Key.Add(Constraint);
+		Key.Add(Knowledge[Constraint]);
+	}
+
+	uint32 Hash = GetTypeHash(Variables.Num());
+	for (const int32 Value : Key)
+	{
+		Hash = HashCombine(Hash, GetTypeHash(Value));
+	}
+
+	if (const FComponentSolution* CachedSolution = SolutionCache.Find(Hash))
+	{
+		if (CachedSolution->Key == Key)
+		{
+			OutSolution = *CachedSolution;
+			UsedSolutions.Add(Hash, OutSolution);
+			return;
+		}
+	}
+
+	const int32 Stride = Variables.Num() + 1;
+	OutSolution.Key = MoveTemp(Key);
+	OutSolution.MineCountWeights.Init(0.0, Stride);
+	OutSolution.PinnedMineCount = INDEX_NONE;
+
+	TMap<int32, int32> VariableLookup;
+	for (int32 Variable = 0; Variable < Variables.Num(); ++Variable)
+	{
+		VariableLookup.Add(Variables[Variable], Variable);
+	}
+
+	FComponentEnumerator Enumerator;
+	Enumerator.VariableConstraints.SetNum(Variables.Num());
+	Enumerator.RemainingMines.SetNumUninitialized(Constraints.Num());
+	Enumerator.UnassignedCounts.SetNumZeroed(Constraints.Num());
+	Enumerator.Assignment.SetNumZeroed(Variables.Num());
+
+	for (int32 Constraint = 0; Constraint < Constraints.Num(); ++Constraint)
+	{
+		const int32 ConstraintIdx = Constraints[Constraint];
+		Enumerator.RemainingMines[Constraint] = Knowledge[ConstraintIdx];
+		Topology.ForEachNeighborIndex(Topology.GetCellPosition(ConstraintIdx), [&](int32 NeighborIdx)
+		{
+			if (const int32* Variable = VariableLookup.Find(NeighborIdx))
+			{
+				Enumerator.VariableConstraints[*Variable].Add(Constraint);
+				Enumerator.UnassignedCounts[Constraint] += 1;
+			}
+		});
+	}
+
+	bool bIsExact = false;
+	if (Variables.Num() <= MAX_EXACT_COMPONENT_SIZE)
+	{
+		OutSolution.CellMineWeights.Init(0.0, Variables.Num() * Stride);
+		Enumerator.MineCountWeights = OutSolution.MineCountWeights.GetData();
+		Enumerator.CellMineWeights = OutSolution.CellMineWeights.GetData();
+		Enumerator.Stride = Stride;
+		Enumerator.Enumerate(0, 0);
+		bIsExact = !Enumerator.bIsAborted;
+	}
+
+	if (bIsExact)
+	{
+		// Only ratios matter, normalizing keeps products of many components in range
+		double SolutionCount = 0.0;
+		for (const double Weight : OutSolution.MineCountWeights)
+		{
+			SolutionCount += Weight;
+		}
+
+		if (SolutionCount > 0.0)
+		{
+			for (double& Weight : OutSolution.MineCountWeights)
+			{
+				Weight /= SolutionCount;
+			}
+			for (double& Weight : OutSolution.CellMineWeights)
+			{
+				Weight /= SolutionCount;
+			}
+		}
+	}
+	else
+	{
+		// Too large to enumerate, estimate each cell from its constraints and pin the component mine count.
+		// Nothing but the pinned mine count carries weight, so each cell keeps its estimate alone
+		FMemory::Memzero(OutSolution.MineCountWeights.GetData(), Stride * sizeof(double));
+
+		TArray<double>& Estimates = OutSolution.CellMineWeights;
+		Estimates.Init(0.0, Variables.Num());
+		double ExpectedMines = 0.0;
+
+		for (int32 Variable = 0; Variable < Variables.Num(); ++Variable)
+		{
+			const TArray<int32, TInlineAllocator<8>>& VariableConstraints = Enumerator.VariableConstraints[Variable];
+			for (const int32 Constraint : VariableConstraints)
+			{
+				Estimates[Variable] += static_cast<double>(Knowledge[Constraints[Constraint]]) / Enumerator.UnassignedCounts[Constraint];
+			}
+			Estimates[Variable] = FMath::Min(1.0, Estimates[Variable] / FMath::Max(1, VariableConstraints.Num()));
+			ExpectedMines += Estimates[Variable];
+		}
+
+		const int32 PinnedMines = FMath::Clamp(FMath::RoundToInt(ExpectedMines), 0, Variables.Num());
+		OutSolution.MineCountWeights[PinnedMines] = 1.0;
+		OutSolution.PinnedMineCount = PinnedMines;
+	}
+
+	UsedSolutions.Add(Hash, OutSolution);
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperGame.h"
+#include "Async/Future.h"
+
+/** Mine probability of every cell as seen by the player, negative for revealed cells */
+struct FMinesweeperProbabilityResult
+{
+	uint32        Revision;
+	TArray<float> MineProbabilities;
+};
+
+/**
+ * Computes mine probability of hidden cells on a worker thread. Designed for:
+ * 1. Owning what the player can see, so the click path only hands over the cells it changed rather than a copy of the board.
+ * 2. Coalescing submissions made while busy, only the latest state gets analyzed.
+ * 3. Caching exact solutions of frontier components, so only the ones touched by the last reveal are recomputed.
+ * 4. Indexing the frontier as changes come in, so finding components never scans the whole board.
+ */
+class FMinesweeperProbabilityAnalyzer
+{
+public:
+	/** Knowledge value of a cell that has not been revealed yet */
+	static constexpr int8 HIDDEN_CELL = -1;
+
+	using FResultPtr = TSharedPtr<const FMinesweeperProbabilityResult, ESPMode::ThreadSafe>;
+
+	FMinesweeperProbabilityAnalyzer();
+	~FMinesweeperProbabilityAnalyzer();
+
+	FMinesweeperProbabilityAnalyzer(const FMinesweeperProbabilityAnalyzer&) = delete;
+	FMinesweeperProbabilityAnalyzer& operator=(const FMinesweeperProbabilityAnalyzer&) = delete;
+
+	/**
+	 * Queues a whole board for analysis, replacing anything the worker has not picked up yet. The board is moved in.
+	 * Knowledge holds, in storage order of the board, the neighbor mine count of revealed cells and HIDDEN_CELL otherwise.
+	 * Returns the revision the matching result will carry.
+	 */
+	uint32 SubmitBoard(const FMinesweeperGameConfig& Config, TArray<int8>&& Knowledge);
+
+	/**
+	 * Queues changes to the board last submitted, merged with any the worker has not picked up yet.
+	 * GetKnowledge tells the knowledge of each changed cell. Returns the revision the matching result will carry.
+	 */
+	uint32 SubmitChanges(TConstArrayView<int32> ChangedCells, TFunctionRef<int8(int32 Idx)> GetKnowledge);
+
+	/** Latest finished result, if any. Never waits for analysis in flight */
+	FResultPtr GetLatestResult() const;
+
+private:
+	struct FSnapshot
+	{
+		uint32                 Revision;
+		FMinesweeperGameConfig Config;
+		TArray<int8>           Knowledge;
+	};
+
+	struct FKnowledgeChange
+	{
+		int32 Idx;
+		int8  Knowledge;
+	};
+
+	/** Solution of one frontier component, weights are indexed by mine count of the component */
+	struct FComponentSolution
+	{
+		TArray<int32>  Key;
+		TArray<double> MineCountWeights;
+		/**
+		 * Per variable weights, laid out as [VariableIdx * MineCountWeights.Num() + MineCount].
+		 * Estimated components only weigh their pinned mine count, and keep a single weight per variable.
+		 */
+		TArray<double> CellMineWeights;
+		int32          PinnedMineCount;
+	};
+
+	/** Cells in no particular order, with constant time insertion, removal and membership test */
+	struct FCellSet
+	{
+		/** Dense cells in order of insertion, removal swaps the last cell into the gap */
+		TArray<int32> Cells;
+		/** Position of every cell in Cells, INDEX_NONE if it is not in the set */
+		TArray<int32> DenseIndices;
+
+		void Reset(int32 CellCount);
+		void Add(int32 Idx);
+		void Remove(int32 Idx);
+
+		FORCEINLINE bool Contains(int32 Idx) const
+		{
+			return DenseIndices[Idx] != INDEX_NONE;
+		}
+	};
+
+	/** Frontier cells sharing constraints, and the revealed numbers constraining them */
+	struct FComponent
+	{
+		TArray<int32> Variables;
+		TArray<int32> Constraints;
+	};
+
+	void StartWorker();
+	void RunWorker();
+	void Analyze(FMinesweeperProbabilityResult& OutResult);
+
+	template <typename TTopology>
+	void RebuildFrontierIndex(const TTopology& Topology);
+	template <typename TTopology>
+	void ApplyChanges(const TTopology& Topology);
+	void UpdateFrontierIndex(int32 Idx);
+	void RebuildLogFactorials(int32 CellCount);
+
+	template <typename TTopology>
+	void FindComponents(const FSnapshot& Snapshot, const TTopology& Topology, TArray<FComponent>& OutComponents);
+
+	template <typename TTopology>
+	void SolveComponent(const FSnapshot& Snapshot, const TTopology& Topology, const FComponent& Component, FComponentSolution& OutSolution);
+
+private:
+	mutable FCriticalSection Lock;
+	/** Board submitted since the worker last picked one up, with the changes submitted after it */
+	bool                     bHasPendingSubmission;
+	bool                     bHasPendingBoard;
+	FMinesweeperGameConfig   PendingConfig;
+	TArray<int8>             PendingKnowledge;
+	TArray<FKnowledgeChange> PendingChanges;
+	uint32                   PendingRevision;
+	FResultPtr               LatestResult;
+	TFuture<void>            WorkerFuture;
+	uint32                   LatestRevision;
+	bool                     bIsWorkerRunning;
+
+	/** Worker thread only. Board the changes get applied to, owned by the worker across analyses */
+	FSnapshot                WorkerSnapshot;
+	TArray<FKnowledgeChange> WorkerChanges;
+	bool                     bIsFrontierIndexStale;
+
+	/**
+	 * Worker thread only. Revealed numbers with hidden neighbors and hidden cells next to revealed numbers,
+	 * kept up to date from the neighbor counts of every cell as changes get applied.
+	 */
+	FCellSet      ConstraintCells;
+	FCellSet      VariableCells;
+	TArray<uint8> HiddenNeighborCounts;
+	TArray<uint8> NumberNeighborCounts;
+	int32         HiddenCellCount;
+
+	/** Worker thread only. Logarithm of the factorial of every count up to that of the cells, built once per board size */
+	TArray<double> LogFactorials;
+
+	/** Worker thread only. Solutions used by the last analysis keyed by component hash */
+	TMap<uint32, FComponentSolution> SolutionCache;
+	TMap<uint32, FComponentSolution> UsedSolutions;
+	TArray<int32>                    ComponentParents;
+};
@@ -0,0 +1,284 @@
+#include "MinesweeperSolver.h"
+#include "MinesweeperGameArena.h"
+#include "MinesweeperGrid.h"
+#include "Algo/AllOf.h"
+
+using namespace MinesweeperGrid;
+
+template <typename TTopology>
+TMinesweeperSolver<TTopology>::TMinesweeperSolver(const TTopology& InTopology, FMinesweeperGameArena& Arena) :
+	Topology{InTopology},
+	Knowledge{Arena.Allocate<EKnowledge>(InTopology.GetCellCount())},
+	ActiveCells{Arena.Allocate<FCell>(InTopology.GetCellCount())},
+	ActiveCellCount{0},
+	RevealQueue{Arena.Allocate<FCell>(InTopology.GetCellCount())},
+	RevealQueueCount{0},
+	RemainingSafeCellCount{0},
+	RemainingMineCount{0}
+{
+}
+
+template <typename TTopology>
+bool TMinesweeperSolver<TTopology>::Solve(TConstArrayView<FMineCell> InCells, int32 MineCount, int32 StartIdx)
+{
+	const int32 CellCount = Topology.GetCellCount();
+	check(InCells.Num() == CellCount);
+
+	Cells = InCells;
+	for (EKnowledge& CellKnowledge : Knowledge)
+	{
+		CellKnowledge = EKnowledge::Unknown;
+	}
+	ActiveCellCount = 0;
+	RevealQueueCount = 0;
+	RemainingSafeCellCount = CellCount - MineCount;
+	RemainingMineCount = MineCount;
+
+	if (InCells[StartIdx].IsMine())
+	{
+		return false;
+	}
+
+	RevealCell(FCell{StartIdx, Topology.GetCellPosition(StartIdx)});
+
+	while (RemainingSafeCellCount > 0)
+	{
+		// Cheaper rules first, falling back to more expensive ones only when stuck
+		const bool bHasProgress = ApplySinglePointRule() || ApplySubsetRule() || ApplyGlobalRule();
+		if (!bHasProgress)
+		{
+			break;
+		}
+	}
+
+	return RemainingSafeCellCount == 0;
+}
+
+template <typename TTopology>
+void TMinesweeperSolver<TTopology>::RevealCell(const FCell& Cell)
+{
+	if (Knowledge[Cell.Idx] != EKnowledge::Unknown)
+	{
+		return;
+	}
+
+	RevealQueueCount = 0;
+	MarkSafe(Cell);
+
+	// Same cascade a player gets when revealing a cell without neighboring mines
+	while (RevealQueueCount > 0)
+	{
+		const FCell Current = RevealQueue[--RevealQueueCount];
+
+		if (Cells[Current.Idx].NeighborMineCount == 0)
+		{
+			Topology.ForEachNeighbor(Current.Pos, [this](int32 NeighborIdx, const FPosition& NeighborPos)
+			{
+				if (Knowledge[NeighborIdx] == EKnowledge::Unknown)
+				{
+					MarkSafe(FCell{NeighborIdx, NeighborPos});
+				}
+			});
+		}
+		else
+		{
+			ActiveCells[ActiveCellCount++] = Current;
+		}
+	}
+}
+
+template <typename TTopology>
+void TMinesweeperSolver<TTopology>::MarkSafe(const FCell& Cell)
+{
+	checkf(!Cells[Cell.Idx].IsMine(), TEXT("Solver deduced a mine as safe."));
+	Knowledge[Cell.Idx] = EKnowledge::Safe;
+	--RemainingSafeCellCount;
+	RevealQueue[RevealQueueCount++] = Cell;
+}
+
+template <typename TTopology>
+void TMinesweeperSolver<TTopology>::MarkMine(int32 Idx)
+{
+	if (Knowledge[Idx] == EKnowledge::Unknown)
+	{
+		checkf(Cells[Idx].IsMine(), TEXT("Solver deduced a safe cell as mine."));
+		Knowledge[Idx] = EKnowledge::Mine;
+		--RemainingMineCount;
+	}
+}
+
+template <typename TTopology>
+int32 TMinesweeperSolver<TTopology>::GatherUnknownNeighbors(
+	const FCell& Cell,
+	typename TMinesweeperSolver<TTopology>::FNeighborList& OutUnknown) const
+{
+	int32 KnownMineCount = 0;
+
+	OutUnknown.Reset();
+	Topology.ForEachNeighbor(Cell.Pos, [&](int32 NeighborIdx, const FPosition& NeighborPos)
+	{
+		switch (Knowledge[NeighborIdx])
+		{
+		case EKnowledge::Unknown:
+			OutUnknown.Add(FCell{NeighborIdx, NeighborPos});
+			break;
+		case EKnowledge::Mine:
+			++KnownMineCount;
+			break;
+		default:
+			break;
+		}
+	});
+
+	return Cells[Cell.Idx].NeighborMineCount - KnownMineCount;
+}
+
+template <typename TTopology>
+bool TMinesweeperSolver<TTopology>::ApplySinglePointRule()
+{
+	bool bHasProgress = false;
+	FNeighborList Unknown;
+
+	for (int32 ActiveIdx = 0; ActiveIdx < ActiveCellCount;)
+	{
+		const FCell Active = ActiveCells[ActiveIdx];
+		const int32 UnknownMineCount = GatherUnknownNeighbors(Active, Unknown);
+
+		// Fully resolved numbers never contribute again
+		if (Unknown.Num() == 0)
+		{
+			ActiveCells[ActiveIdx] = ActiveCells[--ActiveCellCount];
+			continue;
+		}
+
+		if (UnknownMineCount == 0)
+		{
+			for (const FCell& UnknownCell : Unknown)
+			{
+				RevealCell(UnknownCell);
+			}
+			bHasProgress = true;
+		}
+		else if (UnknownMineCount == Unknown.Num())
+		{
+			for (const FCell& UnknownCell : Unknown)
+			{
+				MarkMine(UnknownCell.Idx);
+			}
+			bHasProgress = true;
+		}
+
+		++ActiveIdx;
+	}
+
+	return bHasProgress;
+}
+
+template <typename TTopology>
+bool TMinesweeperSolver<TTopology>::ApplySubsetRule()
+{
+	FNeighborList UnknownA;
+	FNeighborList UnknownB;
+	FNeighborList Difference;
+	TArray<FCell, TInlineAllocator<TTopology::MAX_NEIGHBOR_COUNT * TTopology::MAX_NEIGHBOR_COUNT>> Candidates;
+
+	for (const FCell& CellA : ActiveCells.Slice(0, ActiveCellCount))
+	{
+		const int32 MineCountA = GatherUnknownNeighbors(CellA, UnknownA);
+		if (UnknownA.Num() == 0)
+		{
+			continue;
+		}
+
+		// Only numbers next to one of A's hidden neighbors can share hidden neighbors with A
+		Candidates.Reset();
+		for (const FCell& UnknownCell : UnknownA)
+		{
+			Topology.ForEachNeighbor(UnknownCell.Pos, [&](int32 NeighborIdx, const FPosition& NeighborPos)
+			{
+				const bool bIsCandidate = NeighborIdx != CellA.Idx
+					&& Knowledge[NeighborIdx] == EKnowledge::Safe
+					&& Cells[NeighborIdx].NeighborMineCount > 0;
+
+				if (bIsCandidate)
+				{
+					Candidates.AddUnique(FCell{NeighborIdx, NeighborPos});
+				}
+			});
+		}
+
+		for (const FCell& CellB : Candidates)
+		{
+			const int32 MineCountB = GatherUnknownNeighbors(CellB, UnknownB);
+			if (UnknownB.Num() <= UnknownA.Num())
+			{
+				continue;
+			}
+
+			const bool bIsSubset = Algo::AllOf(UnknownA, [&UnknownB](const FCell& Cell)
+			{
+				return UnknownB.Contains(Cell);
+			});
+
+			if (!bIsSubset)
+			{
+				continue;
+			}
+
+			Difference.Reset();
+			for (const FCell& Cell : UnknownB)
+			{
+				if (!UnknownA.Contains(Cell))
+				{
+					Difference.Add(Cell);
+				}
+			}
+
+			// Cells only B can see hold exactly the mines B has beyond A
+			const int32 DifferenceMineCount = MineCountB - MineCountA;
+			if (DifferenceMineCount == 0)
+			{
+				for (const FCell& Cell : Difference)
+				{
+					RevealCell(Cell);
+				}
+				return true;
+			}
+
+			if (DifferenceMineCount == Difference.Num())
+			{
+				for (const FCell& Cell : Difference)
+				{
+					MarkMine(Cell.Idx);
+				}
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+template <typename TTopology>
+bool TMinesweeperSolver<TTopology>::ApplyGlobalRule()
+{
+	if (RemainingMineCount > 0)
+	{
+		return false;
+	}
+
+	// Every mine is accounted for, so whatever is left is safe
+	Topology.ForEachCell([this](int32 Idx, const FPosition& Pos)
+	{
+		if (Knowledge[Idx] == EKnowledge::Unknown)
+		{
+			RevealCell(FCell{Idx, Pos});
+		}
+	});
+
+	return true;
+}
+
+#define INSTANTIATE_SOLVER(TTopology) template class TMinesweeperSolver<TTopology>;
+MINESWEEPER_FOR_EACH_TOPOLOGY(INSTANTIATE_SOLVER)
+#undef INSTANTIATE_SOLVER
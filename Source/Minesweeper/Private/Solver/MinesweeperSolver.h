@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperGame.h"
+#include "MinesweeperGrid.h"
+
+class FMinesweeperGameArena;
+
+/**
+ * Deterministic minesweeper solver that only makes moves deducible by logic:
+ * 1. Single point rule: a number whose remaining mines equal zero or its hidden neighbor count.
+ * 2. Subset rule: a number whose hidden neighbors contain those of a nearby number.
+ * 3. Global rule: all remaining hidden cells are safe (or mines) once the mine count is used up.
+ * The solver reads mine positions only to answer reveals, just like a player would.
+ * Instantiated for every topology policy in MinesweeperGrid.h.
+ */
+template <typename TTopology>
+class TMinesweeperSolver
+{
+public:
+	/** Buffers for a board of the topology come from the arena of the game, so that solving never allocates */
+	TMinesweeperSolver(const TTopology& InTopology, FMinesweeperGameArena& Arena);
+
+	/** Plays the board starting from cell StartIdx. Returns true if every safe cell got revealed without guessing */
+	bool Solve(TConstArrayView<FMineCell> Cells, int32 MineCount, int32 StartIdx);
+
+	/** Whether the cell was neither revealed nor deduced as a mine by the last Solve */
+	FORCEINLINE bool IsUndetermined(int32 Idx) const
+	{
+		return Knowledge[Idx] == EKnowledge::Unknown;
+	}
+
+	/** Whether the cell was revealed by the last Solve */
+	FORCEINLINE bool IsRevealed(int32 Idx) const
+	{
+		return Knowledge[Idx] == EKnowledge::Safe;
+	}
+
+	/**
+	 * Invokes Func with the index of every undetermined cell next to a number revealed by the last Solve,
+	 * once per such number. Only walks the numbers still in play rather than the whole board.
+	 */
+	template <typename FuncType>
+	void ForEachFrontierCell(FuncType&& Func) const
+	{
+		for (const FCell& Active : ActiveCells.Slice(0, ActiveCellCount))
+		{
+			Topology.ForEachNeighborIndex(Active.Pos, [&](int32 NeighborIdx)
+			{
+				if (Knowledge[NeighborIdx] == EKnowledge::Unknown)
+				{
+					Func(NeighborIdx);
+				}
+			});
+		}
+	}
+
+private:
+	enum class EKnowledge : uint8
+	{
+		Unknown,
+		Safe,
+		Mine,
+	};
+
+	using FPosition = typename TTopology::FPosition;
+
+	/** Cells get revisited many times, so they carry their position rather than dividing their index each time */
+	struct FCell
+	{
+		int32     Idx;
+		FPosition Pos;
+
+		FORCEINLINE bool operator==(const FCell& Other) const
+		{
+			return Idx == Other.Idx;
+		}
+	};
+
+	using FNeighborList = TArray<FCell, TInlineAllocator<TTopology::MAX_NEIGHBOR_COUNT>>;
+
+	void RevealCell(const FCell& Cell);
+	void MarkSafe(const FCell& Cell);
+	void MarkMine(int32 Idx);
+
+	/** Collects unknown neighbors of a revealed cell and returns how many of its mines are still unknown */
+	int32 GatherUnknownNeighbors(const FCell& Cell, FNeighborList& OutUnknown) const;
+
+	bool ApplySinglePointRule();
+	bool ApplySubsetRule();
+	bool ApplyGlobalRule();
+
+private:
+	TTopology                  Topology;
+	TConstArrayView<FMineCell> Cells;
+
+	TArrayView<EKnowledge> Knowledge;
+
+	/** Revealed numbered cells that may still have unknown neighbors, every cell gets in at most once per solve */
+	TArrayView<FCell> ActiveCells;
+	int32             ActiveCellCount;
+
+	/** Cells are marked safe as they get queued, so the queue never holds a cell twice */
+	TArrayView<FCell> RevealQueue;
+	int32             RevealQueueCount;
+
+	int32 RemainingSafeCellCount;
+	int32 RemainingMineCount;
+};
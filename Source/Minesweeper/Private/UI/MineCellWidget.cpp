@@ -23,6 +23,18 @@ FMineCellWidget::FMineCellWidget()
 			]
 		];
 
+	// Button only handles left clicks, right clicks bubble up to its container
+	ContainerWidget->SetOnMouseButtonDown(FPointerEventHandler::CreateLambda([this](const FGeometry&, const FPointerEvent& MouseEvent)
+	{
+		if (MouseEvent.GetEffectingButton() != EKeys::RightMouseButton)
+		{
+			return FReply::Unhandled();
+		}
+
+		OnWidgetRightClicked.ExecuteIfBound();
+		return FReply::Handled();
+	}));
+
 	SetCellText(FText::AsNumber(0), FLinearColor::Transparent);
 	SetCellColor(FLinearColor::White);
 	GetWidget()->Invalidate(EInvalidateWidgetReason::Paint);
@@ -5,7 +5,7 @@
 DECLARE_DELEGATE(FOnWidgetClicked)
 
 /**
- * Wrapper of mine cell widget that is able to respond to mouse click event.
+ * Wrapper of mine cell widget that is able to respond to left and right mouse click events.
  * Can also set background color and text of a cell.
  */
 class FMineCellWidget
@@ -22,6 +22,7 @@ public:
 
 public:
 	FOnWidgetClicked OnWidgetClicked;
+	FOnWidgetClicked OnWidgetRightClicked;
 
 private:
 	TSharedPtr<SWidget> ContainerWidget;
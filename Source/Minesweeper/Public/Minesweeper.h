@@ -24,4 +24,8 @@ private:
 	TUniquePtr<class FMinesweeperController> PluginController;
 	TUniquePtr<class FMinesweeperView>       PluginView;
 	TUniquePtr<struct FMinesweeperModel>     PluginModel;
+	TUniquePtr<class FMinesweeperGameWorker> PluginGameWorker;
+	TUniquePtr<class FMinesweeperSpectatorServer> PluginSpectatorServer;
+	TUniquePtr<class FMinesweeperLatencyStats>    PluginLatencyStats;
+	TUniquePtr<class FMinesweeperStatsStore>      PluginStatsStore;
 };
\ No newline at end of file